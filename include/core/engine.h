@@ -2,8 +2,67 @@
 #include <vma/vk_mem_alloc.h>
 #include <glm/mat4x4.hpp>
 
+// Upper bound of EngineConfig::framesInFlight, per-frame arrays are sized for it
+constexpr int MAX_FRAMES_IN_FLIGHT = 4;
+
+#include "core/profiling/cpu_profiler.h"
+#include "core/profiling/gpu_profiler.h"
+#include "core/profiling/frame_stats.h"
+#include "core/profiling/perf_overlay.h"
+#include "core/profiling/render_counters.h"
+#include "core/scene/stress_scene.h"
+#include "core/scene/gpu_scene.h"
+#include "core/scene/particle_system.h"
+#include "core/memory/frame_arena.h"
+#include "core/memory/gpu_defragmenter.h"
+#include "core/memory/deletion_queue.h"
+#include "core/render/draw_batcher.h"
+#include "core/render/render_queue.h"
+#include "core/render/bindless_registry.h"
+#include "core/render/descriptor_allocator.h"
+#include "core/render/frame_scheduler.h"
+#include "core/render/async_compute.h"
+#include "core/system/frame_pacer.h"
+
 class SDLWindow;
 
+//@brief Startup options for Core (set before run)
+struct EngineConfig
+{
+	// Render into offscreen images instead of a window swapchain
+	bool headless = false;
+	// Offscreen target size (headless only)
+	uint32_t width = 800;
+	uint32_t height = 600;
+	// Frames to render before exiting (0 = until the window closes)
+	uint32_t frameCount = 0;
+	// Frames excluded from frame time statistics
+	uint32_t warmupFrames = 0;
+	// Procedural stress scene (disabled while stress.objectCount is 0)
+	StressSceneConfig stress;
+	// Block sizes of the per resource class memory pools
+	MemoryPoolConfig memory;
+	// Background compaction of the mesh and texture pools
+	DefragConfig defrag;
+	// JSON memory report written at the end of each run (disabled while empty)
+	std::string memoryReportPath;
+	// Per-frame render counters written as CSV at the end of each run (disabled while empty)
+	std::string countersCsvPath;
+	// Show the performance overlay at startup (F1 toggles it, windowed only)
+	bool overlay = false;
+	// Frames the CPU may record ahead of the GPU (1 to MAX_FRAMES_IN_FLIGHT)
+	uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+	// Present mode, frame cap and background throttling (windowed only)
+	PresentConfig present;
+	// Physical device index or name substring (empty = THEWHEEL_DEVICE, else the best scoring device)
+	std::string device;
+	// Particles simulated on the async compute queue every frame (0 = disabled)
+	uint32_t asyncParticles = 0;
+	// CPU trace written on exit (empty = THEWHEEL_TRACE, else no capture)
+	std::string tracePath;
+	Profiler::TraceFormat traceFormat = Profiler::TraceFormat::ChromeJson;
+};
+
 //@brief Contains core engine logic
 class Core 
 {
@@ -13,34 +72,83 @@ private:
 	vk::PhysicalDeviceMemoryProperties m_pDMemoryProperties;
 	vk::raii::Device m_device = nullptr;
 	vk::raii::Pipeline m_graphicsPipeline = nullptr;
+	vk::raii::Pipeline m_instancedPipeline = nullptr;
+	vk::raii::Pipeline m_scenePipeline = nullptr;
 	vk::raii::CommandPool m_commandPools[3] = { nullptr, nullptr, nullptr };
 	std::vector<vk::raii::CommandBuffer> m_commandBuffers[3];
 	std::vector<vk::Image> m_swapChainImages;
 	std::vector<vk::raii::ImageView> m_swapChainImageViews;
 	std::vector<vk::raii::Semaphore> m_presentCompleteSemaphores;
 	std::vector<vk::raii::Semaphore> m_renderFinishedSemaphores;
-	std::vector<vk::raii::Fence> m_inFlightFences;
-	std::vector<vk::Buffer> m_uniformBuffers;
-	std::vector<VmaAllocation> m_uniformBufferAllocations;
-	std::vector<void*> m_uniformBuffersMapped;
-	std::vector<vk::raii::DescriptorSet> m_descriptorSets;
+	UniformRingBuffer m_uniformRing;
+	std::vector<VmaAllocation> m_offscreenAllocations;
 	vk::raii::DebugUtilsMessengerEXT m_debugMessenger = nullptr;
 	vk::raii::Queue m_queues[4] = { nullptr, nullptr, nullptr, nullptr };
 	vk::raii::Instance m_instance = nullptr;
 	vk::Extent2D m_swapChainExtent;
+	vk::SurfaceTransformFlagBitsKHR m_swapChainTransform = vk::SurfaceTransformFlagBitsKHR::eIdentity;
 	vk::raii::Context m_context{};
 	vk::raii::PhysicalDevice m_dGPU = nullptr;
 	vk::raii::SurfaceKHR m_surface = nullptr; 
 	vk::raii::SwapchainKHR m_swapChain = nullptr;
-	vk::raii::DescriptorSetLayout m_descriptorSetLayout = nullptr;
-	vk::raii::DescriptorPool m_descriptorPool = nullptr;
+
+	//@brief Replaced swap chain and semaphores, destroyed once every present that used them finished
+	struct RetiredSwapChain
+	{
+		std::vector<vk::raii::Fence> fences;
+		vk::raii::SwapchainKHR swapChain = nullptr;
+		std::vector<vk::raii::Semaphore> presentComplete;
+		std::vector<vk::raii::Semaphore> renderFinished;
+	};
+
+	std::vector<RetiredSwapChain> m_retiredSwapChains;
+	// Fences of presents to the current swap chain that may not have finished
+	std::vector<vk::raii::Fence> m_pendingPresentFences;
+	std::vector<vk::raii::Fence> m_freePresentFences;
+	// Frame number of the last present (retires swap chains when present fences aren't supported)
+	uint64_t m_lastPresentFrame = 0;
+	vk::DescriptorSetLayout m_descriptorSetLayout;
+	DescriptorAllocator m_descriptorAllocator;
+	vk::raii::Sampler m_textureSampler = nullptr;
+	BindlessRegistry m_bindless;
+	GpuScene m_gpuScene;
 	vk::raii::PipelineLayout m_pipelineLayout = nullptr;
+	GpuProfiler m_gpuProfiler;
+	PerfOverlay m_overlay;
+	FrameStats m_frameStats;
+	// GPU frame times of the current run (the profiler's averages carry over between runs)
+	FrameStats m_gpuFrameStats;
+	StressScene m_stressScene;
+	DrawBatcher m_drawBatcher;
+	RenderQueue m_renderQueue;
+	FrameAllocator m_frameAllocator;
+	Defragmenter m_defragmenter;
+	DeletionQueue m_deletionQueue;
+	FrameScheduler m_frameScheduler;
+	FramePacer m_framePacer;
+	AsyncCompute m_asyncCompute;
+	ParticleSystem m_particles;
+	// GPU time compute and graphics work of a frame ran concurrently
+	FrameStats m_computeOverlap;
+	uint64_t m_measuredHeapAllocations = 0;
+	uint64_t m_measuredUploadBytes = 0;
+	double m_lastFrameMs = 0.0;
+	// VK_EXT_memory_budget is enabled
+	bool m_memoryBudget = false;
+	// VK_KHR_present_id and VK_KHR_present_wait are enabled
+	bool m_presentWait = false;
+	// VK_EXT_surface_maintenance1 and VK_KHR_get_surface_capabilities2 are enabled
+	bool m_surfaceMaintenance = false;
+	// VK_EXT_swapchain_maintenance1 is enabled and presents signal fences
+	bool m_presentFences = false;
+	EngineConfig m_config;
 
 	//		 graphics, compute, transfer, present
 	uint32_t m_familyIndices[4] = { 0, 0, 0, 0 };
 
+	std::string m_tracePath;
+
 	vk::Format m_swapChainSurfaceFormat = vk::Format::eUndefined;
-	uint32_t m_semaphoreIndex = 0;
 	SDLWindow* mp_window = nullptr;
 
 	uint32_t m_frameIndex = 0;
@@ -62,32 +170,50 @@ private:
 
 	//@brief Sets up debug messenger callback
 	void setupDebugMessenger();
-	//@brief Selects physical devices for Vulkan rendering
+	//@brief Selects the highest scoring physical device, or the one named by EngineConfig::device
+	//@brief or THEWHEEL_DEVICE (index or name substring). Throws listing every rejection if none fits.
 	void selectPhysicalDevices();
 	//@brief Creates logical device and specifies queues to use
 	void setupLogicalDevice();
-	//@brief Determines if a physical devices meets desired specifications for graphics purposes
-	//@return True if physical device is a discrete GPU with geometry shader capabilities
-	bool suitableDiscreteGPU(const vk::raii::PhysicalDevice& device);
+	//@brief Scores a physical device by type, device-local heap size and queue topology
+	//@param rejection:	set to why the device can't be used
+	//@return Score (higher is better), or -1 if the device lacks a required feature, extension or queue
+	int64_t scorePhysicalDevice(const vk::raii::PhysicalDevice& device, std::string& rejection);
 	//@brief Creates Vulkan rendering surface
 	void createSurface();
 	//@brief Creates surface swap chain
 	void createSwapChain();
-	//@brief Recreates swap chain
+	//@brief Recreates swap chain from the current one. The old image views are retired to the
+	//@brief deletion queue, the old swap chain and semaphores by retireSwapChain.
 	void recreateSwapChain();
+	//@brief Hands the current swap chain and its semaphores to the present fences that still use
+	//@brief them, or to the deletion queue a swap chain's worth of frames after the last present
+	void retireSwapChain();
+	//@brief Gets an unsignaled fence for the next present and tracks it against the current swap chain
+	vk::Fence acquirePresentFence();
+	//@brief Recycles signaled present fences and destroys retired swap chains whose presents finished
+	void collectPresentFences();
+	//@brief Determines if a suboptimal swap chain no longer matches the surface extent or transform
+	//@return False if recreating would produce the same swap chain (some compositors report
+	//@return suboptimal indefinitely)
+	bool swapChainOutdated();
 	//@brief Cleans swap chain
 	void cleanSwapChain();
 	//@brief Creates image views
 	void createImageViews();
+	//@brief Creates offscreen color targets that stand in for swap chain images (headless)
+	void createOffscreenTargets();
+	//@brief Destroys offscreen color targets
+	void cleanOffscreenTargets();
 	//@brief Creates descriptor bindings for shader pipeline
 	void createDescriptorLayout();
-	//@brief Creates graphics pipeline
+	//@brief Creates graphics pipelines (standard and instanced)
 	void createGraphicsPipeline();
 	//@brief Initializes vk::raii::CommandPool 
 	void createCommandPools();
 	//@brief Initializes vk::raii::CommandBuffer 
 	void createCommandBuffers();
-	//@brief Initializes rendering semaphores and fences
+	//@brief Creates the per frame slot acquire and per swap chain image present semaphores
 	void createSyncObjects();
 	//@brief Initializes images from ktx2 files
 	void createTextureImages();
@@ -95,8 +221,10 @@ private:
 	void createTextureSampler();
 	//@brief Initializes meshes
 	void createMeshes();
-	//@briefs Initializes uniform buffers
+	//@briefs Initializes the per-object uniform ring buffer
 	void createUBOs();
+	//@brief Grows the uniform ring's frame regions to fit objectCount objects (device must be idle)
+	void reserveUniformRing(uint32_t objectCount);
 
 	//@brief Writes commands into vk::raii::CommandBuffer
 	void recordCommandBuffer(uint32_t imageIndex);
@@ -113,19 +241,26 @@ private:
 	vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities);
 	//brief Updates uniform buffers
 	void updateUniformBuffers();
-	//brief Creates descriptor pool
+	//brief Creates the per-frame descriptor allocator
 	void createDescriptorPool();
-	//brief Creates descriptor sets
-	void createDiscriptorSets();
+	//brief Allocates and writes this frame's per-object uniform set
+	//@param buffer:	buffer of ObjectUniforms the set views (VK_NULL_HANDLE = the uniform ring)
+	vk::DescriptorSet allocateObjectSet(VkBuffer buffer = VK_NULL_HANDLE);
 
+	//@brief Records and submits the frame's async compute work (after a successful acquire).
+	//@brief The particle sample is independent of rendering, so graphics doesn't wait on it.
+	void submitAsyncCompute();
 	//@brief Executes rendering logic called each frame
 	void draw();
-	//@brief Initializes data members
-	void init();
+	//@brief Executes rendering logic for a frame without presenting (headless)
+	void drawOffscreen();
 	//@brief Core engine loop
 	void loop();
-	//@brief Cleans engine data members
-	void clean();
+	//@brief Runs the stress scene once per configured object count and records results
+	void runStressScene();
+	//@brief Writes the memory report and render counters to their configured paths,
+	//@brief suffixed with objectCount if non-zero
+	void writeReports(uint32_t objectCount);
 
 public:
 	//@brief Gets static instance
@@ -136,6 +271,37 @@ public:
 	//@brief Runs engine
 	void run();
 
+	//@brief Initializes data members (run does this; exposed for tools that drive Core without loop)
+	void init();
+	//@brief Cleans engine data members
+	void clean();
+
+	//@brief Sets startup options (must be called before run)
+	void setConfig(const EngineConfig& config)
+	{ m_config = config; }
+
+	const EngineConfig& getConfig() const
+	{ return m_config; }
+
+	//@brief Gets recorded CPU frame times
+	const FrameStats& getFrameStats() const
+	{ return m_frameStats; }
+
+	//@brief Gets average global heap allocations per measured frame
+	double getHeapAllocationsPerFrame() const
+	{ return m_frameStats.getFrameTimes().empty() ? 0.0 :
+		static_cast<double>(m_measuredHeapAllocations) / static_cast<double>(m_frameStats.getFrameTimes().size()); }
+
+	//@brief Gets per-frame scratch memory (reset when the frame's fence signals)
+	FrameAllocator& getFrameAllocator()
+	{ return m_frameAllocator; }
+
+	vk::raii::Device& getDevice()
+	{ return m_device; }
+
+	vk::raii::PhysicalDevice& getPhysicalDevice()
+	{ return m_dGPU; }
+
 	const vk::PhysicalDeviceMemoryProperties& getGPUMemoryProperties() const
 	{ return m_pDMemoryProperties; }
 
@@ -157,6 +323,49 @@ public:
 	vk::raii::CommandPool& getCommandPool(QType queueType)
 	{ return m_commandPools[queueType]; }
 
+	//@brief Gets batcher that turns per-object draw requests into instanced draws
+	DrawBatcher& getDrawBatcher()
+	{ return m_drawBatcher; }
+
+	//@brief Gets the global bindless descriptor set registry
+	BindlessRegistry& getBindlessRegistry()
+	{ return m_bindless; }
+
+	//@brief Gets the queue that destroys resources once the GPU is done with them
+	DeletionQueue& getDeletionQueue()
+	{ return m_deletionQueue; }
+
+	FrameScheduler& getFrameScheduler()
+	{ return m_frameScheduler; }
+
+	//@brief Gets the background defragmenter of the Mesh and Texture pools
+	Defragmenter& getDefragmenter()
+	{ return m_defragmenter; }
+
+	//@brief Gets the compute queue dispatcher (initialized while asyncParticles is non-zero)
+	AsyncCompute& getAsyncCompute()
+	{ return m_asyncCompute; }
+
+	//@brief Gets per-frame overlap of async compute and graphics GPU work of the last run
+	const FrameStats& getComputeOverlapStats() const
+	{ return m_computeOverlap; }
+
+	//@brief Gets input-to-photon latencies of the last run (empty without VK_KHR_present_wait)
+	const FrameStats& getLatencyStats() const
+	{ return m_framePacer.getLatencyStats(); }
+
+	//@brief Gets the persistent GPU-resident object buffer
+	GpuScene& getGpuScene()
+	{ return m_gpuScene; }
+
+	//@brief Gets the queue recorded into the main pass each frame
+	RenderQueue& getRenderQueue()
+	{ return m_renderQueue; }
+
+	//@brief Gets GPU pass profiler
+	GpuProfiler& getGpuProfiler()
+	{ return m_gpuProfiler; }
+
 	//@brief Gets queue for a given queueType
 	//@param  queueType:	enum value representing queue type
 	//@return vk::raii::Queue&
@@ -167,4 +376,20 @@ public:
 struct UniformBufferObject 
 {
 	glm::mat4 model, view, proj;
+};
+
+//@brief Push constants shared by every graphics pipeline (matches DrawConstants in the shaders)
+struct DrawConstants
+{
+	glm::mat4 viewProj;
+	// Bindless storage buffer slot of the GpuScene buffer
+	uint32_t sceneBuffer;
+	uint32_t pad[3];
+};
+
+//@brief Per-object constants written into the uniform ring (matches ObjectUniforms in the shaders)
+struct ObjectUniforms
+{
+	glm::mat4 model;
+	glm::vec4 color;
 };
\ No newline at end of file
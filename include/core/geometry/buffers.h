@@ -1,14 +1,103 @@
 #pragma once
 #include "enums.h"
 
+//@brief Block sizes of the per resource class VMA pools
+struct MemoryPoolConfig
+{
+	//					 mesh,     texture,  staging,  uniform
+	vk::DeviceSize blockSize[MTypeCount] = { 64 << 20, 128 << 20, 32 << 20, 32 << 20 };
+};
+
+//@brief Budget and usage of one device memory heap
+struct HeapUsage
+{
+	uint32_t heapIndex = 0;
+	bool deviceLocal = false;
+	// Bytes the process may use before allocations start failing or evicting (estimated without
+	// VK_EXT_memory_budget)
+	uint64_t budget = 0;
+	// Bytes the process currently uses, including other processes' view when the budget is exact
+	uint64_t usage = 0;
+	// VMA blocks and the allocations placed in them
+	uint64_t blockBytes = 0;
+	uint64_t allocationBytes = 0;
+};
+
+//@brief Totals of one resource class
+struct CategoryUsage
+{
+	const char* name = "";
+	uint32_t blockCount = 0;
+	uint32_t allocationCount = 0;
+	uint64_t blockBytes = 0;
+	uint64_t allocationBytes = 0;
+	// 1 - largest free range / free bytes: 0 when free space is contiguous, towards 1 when scattered
+	float fragmentation = 0.0f;
+};
+
+//@brief Host memory the driver and VMA allocated through the engine's VkAllocationCallbacks
+struct HostUsage
+{
+	uint64_t bytes = 0;
+	uint64_t peakBytes = 0;
+	uint64_t liveAllocations = 0;
+	uint64_t totalAllocations = 0;
+	// Driver-side allocations reported through the internal allocation notifications
+	uint64_t internalBytes = 0;
+};
+
+//@brief Snapshot of device and host memory use
+struct MemoryReport
+{
+	std::vector<HeapUsage> heaps;
+	// One entry per MType pool followed by the default pools
+	std::vector<CategoryUsage> categories;
+	HostUsage host;
+};
+
 namespace Allocator 
 {
+	//@brief Creates the VMA allocator and one custom pool per MType:
+	//@brief TLSF pools for meshes, textures and the mapped uniform rings and streams,
+	//@brief and a linear pool for staging
+	//@param memoryBudget:	VK_EXT_memory_budget is enabled on device
 	void Init(vk::raii::Instance& instance,
 		vk::raii::PhysicalDevice& physicalDevice,
-		vk::raii::Device& device);
+		vk::raii::Device& device,
+		const MemoryPoolConfig& poolConfig = {},
+		bool memoryBudget = false);
 
 	VmaAllocator& GetAllocator();
 
+	//@brief Gets the custom pool of a resource class (VK_NULL_HANDLE for MTypeCount)
+	VmaPool GetPool(MType memType);
+
+	//@brief Gets a resource class's display name
+	const char* GetPoolName(MType memType);
+
+	//@brief Gets block and allocation statistics of a resource class's pool
+	VmaDetailedStatistics GetPoolStats(MType memType);
+
+	//@brief Gets host callbacks that track the driver's and VMA's CPU allocations. Pass them to
+	//@brief instance and device creation, and when destroying handles VMA created.
+	const vk::AllocationCallbacks* GetHostCallbacks();
+
+	//@brief Gets per-heap budgets and usage (cheap enough to poll during frames)
+	std::vector<HeapUsage> GetHeapUsage();
+
+	//@brief Gets per-heap budgets, per resource class totals and host allocations
+	MemoryReport GetReport();
+
+	//@brief Prints the memory report
+	void PrintReport(std::ostream& out);
+
+	//@brief Writes the memory report and VMA's detailed statistics (vmaBuildStatsString) as JSON
+	//@return false if path can't be written
+	bool WriteReportJson(const std::string& path);
+
+	//@brief Gets bytes currently allocated across all memory heaps
+	uint64_t GetTotalUsage();
+
 	void Clean();
 };
 
@@ -46,6 +135,38 @@ struct Vertex
 	}
 };
 
+//@brief Per-instance attributes streamed through vertex binding 1 (matches VSInput in instanced.slang)
+struct InstanceData
+{
+	glm::mat4 transform;
+	glm::vec4 color;
+	uint32_t materialIndex = 0;
+	uint32_t pad[3] = { 0, 0, 0 };
+
+	static vk::VertexInputBindingDescription getBindingDesc() {
+		return { 1, sizeof(InstanceData), vk::VertexInputRate::eInstance };
+	}
+
+	static std::array<vk::VertexInputAttributeDescription, 6> getAttribDesc() {
+		return {
+			vk::VertexInputAttributeDescription(2, 1, vk::Format::eR32G32B32A32Sfloat, offsetof(InstanceData, transform)),
+			vk::VertexInputAttributeDescription(3, 1, vk::Format::eR32G32B32A32Sfloat, offsetof(InstanceData, transform) + sizeof(glm::vec4)),
+			vk::VertexInputAttributeDescription(4, 1, vk::Format::eR32G32B32A32Sfloat, offsetof(InstanceData, transform) + sizeof(glm::vec4) * 2),
+			vk::VertexInputAttributeDescription(5, 1, vk::Format::eR32G32B32A32Sfloat, offsetof(InstanceData, transform) + sizeof(glm::vec4) * 3),
+			vk::VertexInputAttributeDescription(6, 1, vk::Format::eR32G32B32A32Sfloat, offsetof(InstanceData, color)),
+			vk::VertexInputAttributeDescription(7, 1, vk::Format::eR32Uint, offsetof(InstanceData, materialIndex))
+		};
+	}
+};
+
+//@brief Source data written at offset of a buffer by Buffer::Upload
+struct BufferRegion
+{
+	const void* data;
+	vk::DeviceSize size;
+	vk::DeviceSize offset = 0;
+};
+
 struct CommandInfo
 {
 	vk::raii::CommandBuffer cmd;
@@ -57,12 +178,37 @@ class Buffer
 protected:
 	VkBuffer m_buffer = VK_NULL_HANDLE;
 	VmaAllocation m_allocation = VK_NULL_HANDLE;
+	vk::DeviceSize m_size = 0;
+	// Usage kept so the Defragmenter can recreate the buffer elsewhere (0 = never moved)
+	VkBufferUsageFlags m_usage = 0;
+
+	//@brief Lets the Defragmenter move an uploaded buffer. The object must keep its address
+	//@brief while the buffer is alive (it is stored as the allocation's user data).
+	//@param usage:		usage passed to Buffer::Upload
+	void enableMoves(vk::DeviceSize size, VkBufferUsageFlags usage);
 	
 public:
 	//@brief Gets buffer
 	const VkBuffer& getBuffer()
 	{ return m_buffer; }
 
+	//@brief Gets the buffer size (0 where the owner does not record it)
+	vk::DeviceSize getSize() const
+	{ return m_size; }
+
+	// -----Defragmentation-----
+
+	bool isMovable() const
+	{ return m_usage != 0; }
+
+	//@brief Creates a buffer like this one bound to dstAllocation
+	VkBuffer createMoved(VmaAllocation dstAllocation) const;
+
+	//@brief Swaps in a buffer from createMoved
+	//@return previous buffer (destroy it once no frame in flight uses it)
+	VkBuffer swapBuffer(VkBuffer buffer)
+	{ std::swap(m_buffer, buffer); return buffer; }
+
 	//@brief Deallocates buffer CPU and GPU memory
 	void destroy() 
 	{
@@ -73,10 +219,19 @@ public:
 		}
 	}
 
+	//@brief Hands the buffer to the engine's deletion queue, which destroys it once no
+	//@brief submitted frame uses it. The object can be reused right away.
+	void retire();
+
 
 	// -----Helpers-----
 
+	// Usage added to every buffer created by Upload
+	static constexpr VkBufferUsageFlags UPLOAD_USAGE =
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
 	//@brief Creates a buffer from a set of specifications (i.e. size, usage, properties)
+	//@param memType:	resource class pool to allocate from (memUsage applies if the pool is full)
 	//@return VmaAllocation (use for alloc info access and proper destruction)
 	static VmaAllocation Create(
 		vk::raii::Device& device,
@@ -84,7 +239,22 @@ public:
 		vk::DeviceSize size,
 		VkBufferUsageFlags buffUsage,
 		VmaAllocationCreateFlags allocFlags = 0,
-		VmaMemoryUsage memUsage = VMA_MEMORY_USAGE_AUTO);
+		VmaMemoryUsage memUsage = VMA_MEMORY_USAGE_AUTO,
+		MType memType = MTypeCount);
+
+	//@brief Creates a device-local buffer of size bytes filled with regions. The regions are written
+	//@brief through the mapping when VMA places the buffer in host-visible memory (ReBAR/UMA);
+	//@brief otherwise they are staged and copied in one transfer submission.
+	//@return VmaAllocation (use for alloc info access and proper destruction)
+	static VmaAllocation Upload(
+		vk::raii::Device& device,
+		VkBuffer& buffer,
+		vk::DeviceSize size,
+		VkBufferUsageFlags buffUsage,
+		std::span<const BufferRegion> regions);
+
+	//@brief Checks whether an allocation's memory can be mapped by the host
+	static bool IsHostVisible(VmaAllocation allocation);
 
 	//@brief Copies source buffer into destination buffer
 	static void Copy(
@@ -130,6 +300,178 @@ public:
 	{ return m_numIndices; }
 };
 
+//@brief Sub-allocation inside a UniformRingBuffer
+struct UniformAllocation
+{
+	void* data = nullptr;
+	// Absolute buffer offset, used as the dynamic descriptor offset
+	uint32_t offset = 0;
+};
+
+//@brief Persistently mapped uniform buffer split into one region per frame in flight.
+//@brief Per-object constants are bump allocated into the current frame's region and
+//@brief bound through an eUniformBufferDynamic descriptor with the allocation offset.
+class UniformRingBuffer : public Buffer
+{
+private:
+	std::byte* mp_mapped = nullptr;
+	vk::DeviceSize m_frameSize = 0;
+	vk::DeviceSize m_alignment = 256;
+	vk::DeviceSize m_frameBase = 0;
+	vk::DeviceSize m_head = 0;
+	bool m_coherent = true;
+
+public:
+	UniformRingBuffer() {}
+
+	//@brief Allocates frameCount regions of frameSize bytes
+	//@param minAlignment:	VkPhysicalDeviceLimits::minUniformBufferOffsetAlignment
+	void initBuffer(
+		vk::raii::Device& device,
+		vk::DeviceSize frameSize,
+		uint32_t frameCount,
+		vk::DeviceSize minAlignment);
+
+	//@brief Rewinds to the start of frameIndex's region (its previous use must have completed)
+	void beginFrame(uint32_t frameIndex);
+
+	//@brief Bump allocates size bytes in the current frame's region
+	UniformAllocation allocate(vk::DeviceSize size);
+
+	//@brief Copies value into the ring
+	//@return dynamic offset of the copy
+	template<typename T>
+	uint32_t push(const T& value)
+	{
+		UniformAllocation allocation = allocate(sizeof(T));
+		memcpy(allocation.data, &value, sizeof(T));
+		return allocation.offset;
+	}
+
+	//@brief Flushes the current frame's writes (no-op on host-coherent memory)
+	void flush();
+
+	//@brief Gets bytes allocated in the current frame
+	vk::DeviceSize getUsed() const
+	{ return m_head; }
+
+	//@brief Gets the size of one frame's region (0 before initBuffer)
+	vk::DeviceSize getFrameSize() const
+	{ return m_frameSize; }
+};
+
+//@brief Persistently mapped host-visible buffer that grows on demand (per-frame streams such as
+//@brief instance data or upload lists). Keep one per frame in flight so a frame can be rewritten
+//@brief while others are in use.
+class MappedBuffer : public Buffer
+{
+private:
+	std::byte* mp_mapped = nullptr;
+	vk::DeviceSize m_capacity = 0;
+	bool m_coherent = true;
+
+public:
+	MappedBuffer() {}
+
+	//@brief Grows the buffer to at least size bytes (contents are discarded on growth)
+	//@return true if the buffer was reallocated
+	bool reserve(vk::raii::Device& device, vk::DeviceSize size, VkBufferUsageFlags usage);
+
+	//@brief Flushes the first size bytes (no-op on host-coherent memory)
+	void flush(vk::DeviceSize size);
+
+	std::byte* getData()
+	{ return mp_mapped; }
+
+	vk::DeviceSize getCapacity() const
+	{ return m_capacity; }
+};
+
+//@brief Device buffer whose contents change every frame (dynamic meshes, skinning output, UI geometry).
+//@brief Holds one copy per frame in flight so the current copy can be rewritten while the GPU reads
+//@brief the others. Range writes go to a CPU shadow and are replayed into each copy as it comes up,
+//@brief so partial updates stay consistent across copies without reallocating.
+//@brief On host-visible device-local memory (ReBAR/UMA) copies are written through the mapping,
+//@brief otherwise the frame's ranges are staged and copied with a single copyBuffer in flush.
+class DynamicBuffer : public Buffer
+{
+private:
+	struct DirtyRange
+	{
+		vk::DeviceSize offset;
+		vk::DeviceSize size;
+		// Write generation (copies synced up to it already hold the range)
+		uint64_t generation;
+	};
+
+	std::vector<std::byte> m_shadow;
+	std::vector<DirtyRange> m_dirty;
+	// Per copy, the last write generation it received
+	std::vector<uint64_t> m_syncedGenerations;
+	uint64_t m_generation = 0;
+	std::vector<vk::BufferCopy> m_copies;
+	std::byte* mp_mapped = nullptr;
+	VkBuffer m_stagingBuffer = VK_NULL_HANDLE;
+	VmaAllocation m_stagingAllocation = VK_NULL_HANDLE;
+	std::byte* mp_staging = nullptr;
+	vk::DeviceSize m_stride = 0;
+	uint32_t m_frameCount = 0;
+	uint32_t m_frameIndex = 0;
+	bool m_direct = false;
+	bool m_coherent = true;
+
+	//@brief Clears CPU-side state after the buffers are destroyed or retired
+	void reset();
+
+public:
+	DynamicBuffer() {}
+
+	//@brief Allocates frameCount copies of size bytes
+	//@param usage:		buffer usage of the copies (TRANSFER_DST is added as needed)
+	//@param frameCount:	copies kept (2 = double, 3 = triple buffering)
+	//@param alignment:	alignment of each copy's offset (e.g. minStorageBufferOffsetAlignment)
+	void initBuffer(
+		vk::raii::Device& device,
+		vk::DeviceSize size,
+		VkBufferUsageFlags usage,
+		uint32_t frameCount,
+		vk::DeviceSize alignment = 256);
+
+	//@brief Selects frameIndex's copy (its previous use must have completed)
+	void beginFrame(uint32_t frameIndex);
+
+	//@brief Writes data at offset. Visible in the current copy after flush and in the
+	//@brief following copies once their frames begin.
+	void update(vk::DeviceSize offset, std::span<const std::byte> data);
+
+	template<typename T>
+	void update(vk::DeviceSize offset, std::span<const T> data)
+	{ update(offset, std::as_bytes(data)); }
+
+	//@brief Brings the current copy up to date with every write it hasn't received yet (frames that
+	//@brief skip flush, or flush more than once, stay consistent). On the staging path records the
+	//@brief batched copy and a barrier to dstStage/dstAccess into cmd, so it must be recorded outside
+	//@brief of rendering.
+	void flush(
+		vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 dstStage,
+		vk::AccessFlags2 dstAccess);
+
+	//@brief Destroys the copies and the staging buffer
+	void destroy();
+
+	//@brief Retires the copies and the staging buffer to the engine's deletion queue
+	void retire();
+
+	//@brief Gets the current copy's offset (bind the buffer at this offset)
+	vk::DeviceSize getOffset() const
+	{ return m_stride * m_frameIndex; }
+
+	//@brief True if updates are written straight into device memory
+	bool isDirect() const
+	{ return m_direct; }
+};
+
 template<typename T>
 concept IndexDataTypes = std::is_same_v<T, uint16_t> || std::is_same_v<T, uint32_t>;
 
@@ -165,14 +507,62 @@ class ImageBuffer
 private:
 	VkImage m_image = VK_NULL_HANDLE;
 	VmaAllocation m_allocation = VK_NULL_HANDLE;
+	vk::raii::ImageView m_view = nullptr;
+	// Slot in the bindless texture array (see BindlessRegistry)
+	uint32_t m_bindlessIndex = UINT32_MAX;
+	// Creation info kept so the Defragmenter can recreate the image elsewhere
+	VkExtent3D m_extent = { 0, 0, 0 };
+	VkFormat m_format = VK_FORMAT_UNDEFINED;
+	uint32_t m_mipLevels = 1;
+	VkImageUsageFlags m_usage = 0;
+
+	//@brief Creates the shader-read view of m_image
+	void createView(vk::raii::Device& device, VkFormat format);
+
+	//@brief Records creation info and lets the Defragmenter move the image (the object must
+	//@brief keep its address while the image is alive)
+	void enableMoves(VkExtent3D extent, VkFormat format, uint32_t mipLevels, VkImageUsageFlags usage);
 
 public:
 	//@brief Initializes vertex buffer
 	void initBuffer(vk::raii::Device& device, const char* ktx2ImagePath);
 
+	//@brief Initializes image from tightly packed RGBA8 (sRGB) pixels
+	void initBuffer(vk::raii::Device& device, uint32_t width, uint32_t height, const uint32_t* pixels);
+
 	//@brief Destroys image buffer
 	void destroy();
 
+	//@brief Hands the image, its view and its bindless slot to the engine's deletion queue,
+	//@brief which releases them once no submitted frame uses them
+	void retire();
+
+	VkImage getImage() const
+	{ return m_image; }
+
+	vk::ImageView getView() const
+	{ return *m_view; }
+
+	uint32_t getBindlessIndex() const
+	{ return m_bindlessIndex; }
+
+	void setBindlessIndex(uint32_t index)
+	{ m_bindlessIndex = index; }
+
+	VkExtent3D getExtent() const
+	{ return m_extent; }
+
+	// -----Defragmentation-----
+
+	//@brief Creates an image like this one bound to dstAllocation (contents undefined)
+	VkImage createMoved(VmaAllocation dstAllocation) const;
+
+	//@brief Swaps in an image from createMoved and creates its view (register the view with the
+	//@brief bindless registry afterwards)
+	//@param previousView:	receives the previous view
+	//@return previous image (destroy it and previousView once no frame in flight uses them)
+	VkImage swapImage(vk::raii::Device& device, VkImage image, vk::raii::ImageView& previousView);
+
 	// -----Helpers-----
 
 	//@brief Creates VkImage
@@ -184,9 +574,22 @@ public:
 		VkImageTiling tiling,
 		VkImageUsageFlags usageFlags,
 		VmaAllocationCreateFlags allocFlags = 0,
-		VmaMemoryUsage memUsage = VMA_MEMORY_USAGE_AUTO);
+		VmaMemoryUsage memUsage = VMA_MEMORY_USAGE_AUTO,
+		MType memType = MTypeCount);
+
+	//@brief Creates a 2D VkImage with a single mip level and array layer
+	//@return VmaAllocation (use for alloc info access and proper destruction)
+	static VmaAllocation Create(
+		vk::raii::Device& device,
+		VkImage& image,
+		VkExtent2D extent,
+		VkFormat format,
+		VkImageUsageFlags usageFlags,
+		VmaAllocationCreateFlags allocFlags = 0,
+		VmaMemoryUsage memUsage = VMA_MEMORY_USAGE_AUTO,
+		MType memType = MTypeCount);
 
-	//@brief Copies buffer data into a VkImage
+	//@brief Copies buffer data into a VkImage and leaves it in SHADER_READ_ONLY_OPTIMAL
 	static void Copy(
 		vk::raii::Device& device,
 		VkBuffer& srcBuffer,
@@ -199,4 +602,11 @@ public:
 		const VkImage& image, 
 		VkImageLayout oldLayout, 
 		VkImageLayout newLayout);
+
+	//@brief Records a layout transition barrier into cmd
+	static void RecordTransition(
+		vk::raii::CommandBuffer& cmd,
+		const VkImage& image,
+		VkImageLayout oldLayout,
+		VkImageLayout newLayout);
 };
\ No newline at end of file
@@ -1,4 +1,8 @@
 #pragma once
+#include <array>
+#include <ostream>
+#include <span>
+#include <string>
 #include <utility>
 #include <vector>
 #include <vulkan/vulkan.hpp>
@@ -7,4 +11,5 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
 #include "enums.h"
\ No newline at end of file
@@ -5,6 +5,9 @@ class Mesh
 {
 private:
 	VIBuffer m_buffer;
+	uint32_t m_id = 0;
+
+	static inline uint32_t m_meshCount = 0;
 
 public:
 	//@brief Initializes mesh
@@ -12,7 +15,7 @@ public:
 	void init(vk::raii::Device& device,
 		std::vector<Vertex> const* vertices,
 		std::vector<IndexDataType> const* indices) 
-	{ m_buffer.initBuffer(device, vertices, indices); }
+	{ m_buffer.initBuffer(device, vertices, indices); m_id = m_meshCount++; }
 
 	//brief Binds vertex and index buffers
 	void bind(vk::raii::CommandBuffer& cmd);
@@ -20,6 +23,20 @@ public:
 	//@brief Draws
 	void draw(vk::raii::CommandBuffer& cmd);
 
+	//@brief Draws instanceCount instances starting at firstInstance of the bound instance buffer
+	void draw(vk::raii::CommandBuffer& cmd, uint32_t instanceCount, uint32_t firstInstance);
+
 	void destroy()
 	{ m_buffer.destroy(); }
+
+	//@brief Destroys the mesh once no submitted frame draws it
+	void retire()
+	{ m_buffer.retire(); }
+
+	uint32_t getIndexCount() const
+	{ return m_buffer.getIndicesCount(); }
+
+	//@brief Gets id unique among initialized meshes (used in render queue sort keys)
+	uint32_t getId() const
+	{ return m_id; }
 };
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "core/geometry/buffers.h"
+
+//@brief Defers destruction of GPU resources until the GPU has finished every submission that
+//@brief could still use them. Resources are retired with the current value (the number of the
+//@brief frame being recorded) and destroyed by collect once the completed value reaches it, so
+//@brief meshes and textures can be unloaded at runtime without waiting for the device to idle.
+class DeletionQueue
+{
+private:
+	struct Entry
+	{
+		uint64_t value = 0;
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkImage image = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		vk::raii::ImageView view = nullptr;
+		// Runs after the resources are destroyed (e.g. returns bindless slots)
+		std::function<void()> release;
+	};
+
+	// Sorted by value, so entries complete in order
+	std::deque<Entry> m_entries;
+	std::mutex m_mutex;
+	uint64_t m_currentValue = 0;
+
+	//@brief Destroys an entry's resources and runs its release callback
+	static void Destroy(Entry& entry);
+
+	void push(Entry&& entry);
+
+	//@brief Inserts entry after every entry with a lower or equal value (lock held)
+	void insert(Entry&& entry);
+
+public:
+	//@brief Sets the value later retirements wait for. Call when a frame starts recording.
+	void setCurrentValue(uint64_t value);
+
+	//@brief Destroys everything retired at or before completedValue
+	void collect(uint64_t completedValue);
+
+	//@brief Destroys a VMA buffer once the GPU is done with it
+	void retireBuffer(VkBuffer buffer, VmaAllocation allocation);
+
+	//@brief Destroys a VMA image and its view once the GPU is done with them
+	//@brief (allocation may be VK_NULL_HANDLE if the memory is owned elsewhere)
+	void retireImage(VkImage image, VmaAllocation allocation, vk::raii::ImageView&& view);
+
+	//@brief Runs release once the GPU is done with everything recorded so far
+	void retire(std::function<void()> release);
+
+	//@brief Runs release once the completed value reaches value (may be past the current value)
+	void retireAt(uint64_t value, std::function<void()> release);
+
+	//@brief Destroys a Vulkan RAII object (or a vector of them) once the GPU is done with it
+	template<typename T>
+	void retireObject(T&& object)
+	{
+		auto owned = std::make_shared<std::decay_t<T>>(std::move(object));
+		retire([owned]() { owned->clear(); });
+	}
+
+	//@brief Destroys everything regardless of value (the device must be idle)
+	void flush();
+
+	uint64_t getCurrentValue() const
+	{ return m_currentValue; }
+
+	//@brief Gets the number of resources waiting for the GPU
+	size_t size();
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+//@brief Bump allocator for transient data. Deallocation is a no-op, memory is
+//@brief reclaimed all at once by reset().
+class LinearArena : public std::pmr::memory_resource
+{
+private:
+	struct Block
+	{
+		std::byte* data;
+		size_t size;
+	};
+
+	std::vector<Block> m_blocks;
+	std::byte* mp_head = nullptr;
+	std::byte* mp_end = nullptr;
+	size_t m_blockSize;
+	size_t m_used = 0;
+	size_t m_peak = 0;
+
+	//@brief Chains a new block large enough for bytes + alignment
+	void grow(size_t bytes, size_t alignment);
+	//@brief Frees every block
+	void release();
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void*, size_t, size_t) override {}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{ return this == &other; }
+
+public:
+	LinearArena() : m_blockSize(1 << 20) {}
+	explicit LinearArena(size_t blockSize) : m_blockSize(blockSize) {}
+	~LinearArena() override { release(); }
+
+	LinearArena(const LinearArena&) = delete;
+	LinearArena& operator=(const LinearArena&) = delete;
+
+	//@brief Rewinds the arena. O(1) once the arena fits in one block; if it had to
+	//@brief chain blocks, they are merged into one so later frames don't chain again.
+	void reset();
+
+	//@brief Gets bytes handed out since the last reset
+	size_t getUsed() const
+	{ return m_used; }
+
+	//@brief Gets the largest getUsed() seen before a reset
+	size_t getPeak() const
+	{ return m_peak; }
+};
+
+//@brief One LinearArena per frame in flight plus lazily reset thread-local sub-arenas.
+//@brief A frame's arenas are reset by beginFrame once the frame that last used the slot has completed.
+class FrameAllocator
+{
+private:
+	std::array<LinearArena, MAX_FRAMES_IN_FLIGHT> m_arenas;
+	std::array<std::atomic<uint64_t>, MAX_FRAMES_IN_FLIGHT> m_epochs{};
+	std::atomic<uint32_t> m_frameIndex{ 0 };
+
+public:
+	//@brief Resets the arena of frameIndex (call after FrameScheduler::beginFrame returns it)
+	void beginFrame(uint32_t frameIndex);
+
+	//@brief Gets the current frame's arena (main thread only)
+	LinearArena& get()
+	{ return m_arenas[m_frameIndex.load(std::memory_order_relaxed)]; }
+
+	//@brief Gets the calling thread's arena for the current frame. Worker threads must
+	//@brief finish using it before the frame slot comes around again.
+	LinearArena& threadLocal();
+};
+
+//@brief Vector whose storage lives in a LinearArena
+template<typename T>
+using FrameVector = std::pmr::vector<T>;
+
+//@brief Empties vector and moves its future storage to resource. Polymorphic allocators don't
+//@brief propagate on assignment, so the vector is rebuilt in place; its old storage is reclaimed
+//@brief with the arena it came from.
+template<typename T>
+void RebindFrameVector(FrameVector<T>& vector, std::pmr::memory_resource* resource)
+{
+	std::destroy_at(&vector);
+	std::construct_at(&vector, resource);
+}
+
+namespace HeapStats
+{
+	//@brief Gets the number of global operator new calls so far, aligned forms included
+	//@brief (always 0 when built without THEWHEEL_PROFILING)
+	uint64_t GetAllocationCount();
+};
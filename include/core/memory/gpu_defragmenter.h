@@ -0,0 +1,138 @@
+#pragma once
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "core/geometry/buffers.h"
+
+class BindlessRegistry;
+class FrameScheduler;
+
+//@brief Limits of the background defragmenter
+struct DefragConfig
+{
+	// Run defragmentation passes between frames
+	bool enabled = false;
+	// Bytes and allocations moved per pass
+	vk::DeviceSize maxBytesPerPass = 16 << 20;
+	uint32_t maxMovesPerPass = 64;
+	// CPU time spent preparing moves per frame (the rest is retried by a later pass)
+	double budgetMs = 0.5;
+	// A pool is defragmented once free space inside its blocks exceeds this fraction
+	float minFreeRatio = 0.25f;
+	// Frames between fragmentation checks while idle
+	uint32_t checkInterval = 120;
+};
+
+//@brief Totals since init
+struct DefragStats
+{
+	uint32_t runs = 0;
+	uint32_t passes = 0;
+	uint32_t moves = 0;
+	uint64_t bytesMoved = 0;
+	// Device memory blocks released back to the driver
+	uint32_t blocksFreed = 0;
+};
+
+//@brief Incremental VMA defragmentation of the Mesh and Texture pools, one pass step per frame.
+//@brief Buffers are copied on the transfer queue while frames keep rendering; owners switch to
+//@brief the new buffer once the copy completes, and the old memory is released after every frame
+//@brief in flight that could still read it has retired. Textures are copied on the graphics queue
+//@brief (the copy needs layout transitions) and get a fresh bindless slot, so pending frames keep
+//@brief sampling the old image through the old slot until both are retired. Only resources that
+//@brief called enableMoves are moved.
+class Defragmenter
+{
+private:
+	enum State
+	{
+		Idle,
+		// Context open, next pass not started
+		Ready,
+		// Copies submitted
+		Copying,
+		// Owners switched, waiting for frames in flight to release the old resources
+		Retiring
+	};
+
+	DefragConfig m_config;
+	DefragStats m_stats;
+	VmaDefragmentationContext m_context = VK_NULL_HANDLE;
+	VmaDefragmentationPassMoveInfo m_pass = {};
+	MType m_pool = MTypeCount;
+	State m_state = Idle;
+	uint32_t m_framesLeft = 0;
+	// Last frame that may read the buffers retired by the current pass
+	uint64_t m_retireFrame = 0;
+	uint32_t m_passCount = 0;
+	std::vector<std::pair<Buffer*, VkBuffer>> m_swaps;
+	std::vector<std::pair<ImageBuffer*, VkImage>> m_textureSwaps;
+	std::vector<VkBuffer> m_retired;
+	vk::raii::CommandBuffer m_copyCmd = nullptr;
+	vk::raii::Fence m_copyFence = nullptr;
+	vk::raii::Device* mp_device = nullptr;
+	BindlessRegistry* mp_bindless = nullptr;
+	FrameScheduler* mp_scheduler = nullptr;
+
+	//@brief Checks whether a pool has enough free space inside its blocks to be worth compacting
+	bool isFragmented(MType pool) const;
+
+	//@brief Opens a defragmentation context on pool
+	void begin(MType pool);
+
+	//@brief Starts the next pass and dispatches its moves
+	void beginPass();
+
+	//@brief Creates and copies moved buffers (pass over the Mesh pool)
+	void moveBuffers();
+
+	//@brief Creates and copies moved textures (pass over the Texture pool)
+	void moveTextures();
+
+	//@brief Switches owners to the copied resources of the current pool
+	void swapMoved();
+
+	//@brief Switches owners to the copied buffers and retires the old ones
+	void swapBuffers();
+
+	//@brief Switches owners to the copied textures and fresh bindless slots, and retires the old
+	//@brief images, views and slots through the deletion queue
+	void swapTextures();
+
+	//@brief Destroys retired buffers
+	void destroyRetired();
+
+	//@brief Determines if allocation is the source of any move of the current pass, ignored or not
+	bool inPass(VmaAllocation allocation) const;
+
+	//@brief Commits the current pass
+	void endPass();
+
+	//@brief Closes the context and accumulates its statistics
+	void end();
+
+public:
+	void init(vk::raii::Device& device, BindlessRegistry& bindless, FrameScheduler& scheduler, const DefragConfig& config);
+
+	//@brief Advances defragmentation by one step. Call once per frame after the frame's fence
+	//@brief wait and before recording.
+	void update();
+
+	//@brief Completes the current pass if it contains allocation, so its owner can be retired and
+	//@brief the allocation freed. Blocks for the copy and for the frames that read the old buffers.
+	//@brief Called by the owners' retire and by DeletionQueue before freeing an allocation.
+	void release(VmaAllocation allocation);
+
+	//@brief Completes any open pass and closes the context. The device must be idle.
+	//@brief Call before destroying resources that may be moving.
+	void finish();
+
+	//@brief Prints the totals
+	void printStats(std::ostream& out) const;
+
+	const DefragStats& getStats() const
+	{ return m_stats; }
+
+	bool isRunning() const
+	{ return m_state != Idle; }
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Profiler
+{
+	//@brief A completed CPU zone. name must have static storage duration.
+	struct ZoneEvent
+	{
+		const char* name;
+		uint64_t beginNs;
+		uint64_t endNs;
+	};
+
+	//@brief Single-producer/single-consumer ring owned by one thread.
+	//@brief The owning thread writes head, the collector writes tail.
+	struct ThreadBuffer
+	{
+		static constexpr uint64_t CAPACITY = 1 << 16;
+
+		std::array<ZoneEvent, CAPACITY> events;
+		alignas(64) std::atomic<uint64_t> head{ 0 };
+		alignas(64) std::atomic<uint64_t> tail{ 0 };
+		std::atomic<uint64_t> dropped{ 0 };
+		uint32_t threadId = 0;
+		const char* threadName = nullptr;
+	};
+
+	enum class TraceFormat
+	{
+		ChromeJson,		// chrome://tracing and ui.perfetto.dev both load this
+		PerfettoJson	// Chrome JSON with the displayTimeUnit/metadata Perfetto expects
+	};
+
+	inline std::atomic<bool> g_capturing{ false };
+	inline thread_local ThreadBuffer* tl_buffer = nullptr;
+
+	//@brief Registers the calling thread's ring buffer (slow path, runs once per thread)
+	ThreadBuffer* RegisterThread();
+
+	//@brief Gets monotonic time in nanoseconds
+	inline uint64_t Now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	//@brief Pushes a completed zone into the calling thread's ring buffer
+	inline void Record(const char* name, uint64_t beginNs, uint64_t endNs)
+	{
+		ThreadBuffer* buffer = tl_buffer ? tl_buffer : RegisterThread();
+		uint64_t head = buffer->head.load(std::memory_order_relaxed);
+
+		if (head - buffer->tail.load(std::memory_order_acquire) >= ThreadBuffer::CAPACITY)
+		{
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer->events[head & (ThreadBuffer::CAPACITY - 1)] = { name, beginNs, endNs };
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+
+	//@brief Names the calling thread in exported traces
+	void SetThreadName(const char* name);
+
+	//@brief Starts recording zones (clears previously collected events)
+	void StartCapture();
+
+	//@brief Drains every thread's ring buffer into the capture.
+	//@brief Call regularly (e.g. once per frame) so rings don't overflow.
+	void Collect();
+
+	//@brief Stops recording and writes the capture to disk
+	//@return True if the file was written
+	bool StopCapture(const std::string& path, TraceFormat format = TraceFormat::ChromeJson);
+
+	inline bool IsCapturing()
+	{ return g_capturing.load(std::memory_order_relaxed); }
+};
+
+//@brief Records the lifetime of the object as a CPU zone
+class CpuZone
+{
+private:
+	const char* m_name;
+	uint64_t m_begin;
+
+public:
+	explicit CpuZone(const char* name) : m_name(name), 
+		m_begin(Profiler::IsCapturing() ? Profiler::Now() : 0) {}
+
+	~CpuZone()
+	{
+		if (m_begin != 0)
+			Profiler::Record(m_name, m_begin, Profiler::Now());
+	}
+
+	CpuZone(const CpuZone&) = delete;
+	CpuZone& operator=(const CpuZone&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef THEWHEEL_PROFILING
+#define PROFILE_ZONE(name) CpuZone PROFILE_CONCAT(_cpuZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#endif
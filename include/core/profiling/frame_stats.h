@@ -0,0 +1,44 @@
+#pragma once
+#include <ostream>
+#include <vector>
+
+//@brief Summary statistics over recorded frame times (milliseconds)
+struct FrameTimeSummary
+{
+	size_t count = 0;
+	double mean = 0.0;
+	double min = 0.0;
+	double max = 0.0;
+	double p50 = 0.0;
+	double p95 = 0.0;
+	double p99 = 0.0;
+};
+
+//@brief Collects per-frame times and computes percentile summaries
+class FrameStats
+{
+private:
+	std::vector<double> m_frameTimes;
+
+public:
+	//@brief Reserves storage so recording does not allocate mid-run
+	void reserve(size_t frameCount)
+	{ m_frameTimes.reserve(frameCount); }
+
+	//@brief Records one frame time
+	void record(double ms)
+	{ m_frameTimes.push_back(ms); }
+
+	//@brief Clears recorded frame times
+	void clear()
+	{ m_frameTimes.clear(); }
+
+	//@brief Computes mean, min, max and p50/p95/p99 (nearest-rank)
+	FrameTimeSummary summarize() const;
+
+	//@brief Writes a human readable summary
+	void print(std::ostream& out, const char* label) const;
+
+	const std::vector<double>& getFrameTimes() const
+	{ return m_frameTimes; }
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include <array>
+#include <ostream>
+#include <vector>
+
+//@brief Resolved GPU time of a single profiled pass
+struct GpuPassTiming
+{
+	const char* name = nullptr;
+	uint32_t depth = 0;
+	double ms = 0.0;
+	double avgMs = 0.0;
+};
+
+//@brief Measures GPU pass times with per-frame timestamp query pools.
+//@brief Queries written in frame N are read back when frame slot N is reused,
+//@brief at which point FrameScheduler has waited for frame N, so resolving never stalls.
+class GpuProfiler
+{
+private:
+	struct Scope
+	{
+		const char* name;
+		uint32_t beginQuery;
+		uint32_t endQuery;
+		uint32_t depth;
+	};
+
+	struct FrameQueries
+	{
+		vk::raii::QueryPool pool = nullptr;
+		std::vector<Scope> scopes;
+		uint32_t queryCount = 0;
+	};
+
+	std::array<FrameQueries, MAX_FRAMES_IN_FLIGHT> m_frames;
+	std::vector<GpuPassTiming> m_timings;
+	std::vector<uint32_t> m_openScopes;
+	double m_timestampPeriod = 1.0;
+	double m_frameMs = 0.0;
+	// First and last timestamp of the last resolved frame
+	uint64_t m_frameBegin = 0;
+	uint64_t m_frameEnd = 0;
+	uint64_t m_timestampMask = ~0ull;
+	uint32_t m_maxQueries = 0;
+	uint32_t m_frameIndex = 0;
+	bool m_supported = false;
+	bool m_debugLabels = false;
+
+	//@brief Reads back the queries of the current frame slot into m_timings
+	void resolve();
+
+public:
+	//@brief Creates one timestamp query pool per frame in flight
+	//@param queueFamilyIndex:	family of the queue the profiled command buffers are submitted to
+	//@param debugLabels:		also emit VK_EXT_debug_utils labels for every scope
+	//@param maxScopes:			maximum scopes recorded per frame
+	void init(
+		vk::raii::Device& device,
+		vk::raii::PhysicalDevice& physicalDevice,
+		uint32_t queueFamilyIndex,
+		bool debugLabels,
+		uint32_t maxScopes = 64);
+
+	//@brief Resolves the previous use of this frame slot and resets its queries.
+	//@brief Must be recorded outside of rendering, right after cmd.begin().
+	void beginFrame(vk::raii::CommandBuffer& cmd, uint32_t frameIndex);
+
+	//@brief Opens a named scope (name must have static storage duration)
+	void beginScope(vk::raii::CommandBuffer& cmd, const char* name);
+
+	//@brief Closes the most recently opened scope
+	void endScope(vk::raii::CommandBuffer& cmd);
+
+	//@brief Writes the per-pass timing table
+	void printTimings(std::ostream& out) const;
+
+	//@brief Destroys query pools
+	void clean();
+
+	//@brief Gets the most recently resolved per-pass timings (in recording order)
+	const std::vector<GpuPassTiming>& getPassTimings() const
+	{ return m_timings; }
+
+	//@brief Gets the GPU time between the first and last timestamp of the last resolved frame
+	double getFrameTimeMs() const
+	{ return m_frameMs; }
+
+	bool isSupported() const
+	{ return m_supported; }
+
+	//@brief Gets how long the last resolved frames of two profilers ran at the same time, e.g. a
+	//@brief compute queue's work against graphics. Relies on queues sharing the device timestamp
+	//@brief clock, which current drivers do although the spec only orders timestamps within a queue.
+	static double OverlapMs(const GpuProfiler& a, const GpuProfiler& b);
+};
+
+//@brief Records a GPU scope for the lifetime of the object
+class GpuScope
+{
+private:
+	GpuProfiler& m_profiler;
+	vk::raii::CommandBuffer& m_cmd;
+
+public:
+	GpuScope(GpuProfiler& profiler, vk::raii::CommandBuffer& cmd, const char* name) :
+		m_profiler(profiler), m_cmd(cmd)
+	{ m_profiler.beginScope(m_cmd, name); }
+
+	~GpuScope()
+	{ m_profiler.endScope(m_cmd); }
+
+	GpuScope(const GpuScope&) = delete;
+	GpuScope& operator=(const GpuScope&) = delete;
+};
+
+#define GPU_SCOPE_CONCAT_INNER(a, b) a##b
+#define GPU_SCOPE_CONCAT(a, b) GPU_SCOPE_CONCAT_INNER(a, b)
+#define GPU_SCOPE(profiler, cmd, name) GpuScope GPU_SCOPE_CONCAT(_gpuScope, __LINE__)(profiler, cmd, name)
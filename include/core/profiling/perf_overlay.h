@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <span>
+#include <vector>
+#include "core/geometry/buffers.h"
+#include "core/profiling/gpu_profiler.h"
+
+struct SDL_Window;
+union SDL_Event;
+
+// Frames kept in the frame time graphs
+constexpr uint32_t OVERLAY_HISTORY = 240;
+// Overhead the HUD is allowed before it's drawn as over budget
+constexpr double OVERLAY_BUDGET_MS = 0.2;
+// GPU profiler scope the overlay is recorded in
+constexpr const char* OVERLAY_SCOPE = "Overlay";
+
+//@brief Per-frame values shown by the overlay
+struct OverlayFrameStats
+{
+	double cpuFrameMs = 0.0;
+	double gpuFrameMs = 0.0;
+	std::span<const GpuPassTiming> passes;
+	uint32_t draws = 0;
+	uint64_t triangles = 0;
+	uint64_t uploadBytes = 0;
+	// Last input-to-photon latency (0 when not measured)
+	double latencyMs = 0.0;
+};
+
+//@brief Dear ImGui performance HUD drawn into the main pass through dynamic rendering.
+//@brief Shows CPU and GPU frame time history, per-pass GPU time, draw counts, uploads and
+//@brief heap budgets. Toggled with F1; costs nothing but the key check while hidden.
+class PerfOverlay
+{
+private:
+	std::array<float, OVERLAY_HISTORY> m_cpuHistory = {};
+	std::array<float, OVERLAY_HISTORY> m_gpuHistory = {};
+	std::vector<HeapUsage> m_heaps;
+	vk::raii::DescriptorPool m_descriptorPool = nullptr;
+	// Referenced by the backend's pipeline rendering info
+	VkFormat m_colorFormat = VK_FORMAT_UNDEFINED;
+	uint32_t m_historyIndex = 0;
+	uint32_t m_framesUntilHeapRefresh = 0;
+	double m_buildMs = 0.0;
+	// Own CPU cost (build + record) and GPU cost of the last visible frames, smoothed
+	double m_cpuOverheadMs = 0.0;
+	double m_gpuOverheadMs = 0.0;
+	bool m_initialized = false;
+	bool m_frameBuilt = false;
+
+	static inline bool m_visible = false;
+
+	static void KeyDownCallback(SDL_Event* event);
+	static void InputCallback(SDL_Event* event);
+
+	//@brief Builds the HUD window
+	void buildWindow(const OverlayFrameStats& stats);
+
+public:
+	//@brief Creates the ImGui context and its SDL3 and Vulkan backends
+	//@param colorFormat:	format of the attachment the overlay is rendered into
+	//@param imageCount:	swap chain image count
+	void init(
+		SDL_Window* window,
+		vk::raii::Instance& instance,
+		vk::raii::PhysicalDevice& physicalDevice,
+		vk::raii::Device& device,
+		uint32_t queueFamilyIndex,
+		vk::raii::Queue& queue,
+		vk::Format colorFormat,
+		uint32_t imageCount,
+		bool visible);
+
+	//@brief Records frame stats and builds the HUD. Call once per frame before recording.
+	void beginFrame(const OverlayFrameStats& stats);
+
+	//@brief Records the HUD's draw data. Call inside the pass that renders to the swap chain
+	//@brief image, within a GPU scope named OVERLAY_SCOPE so the HUD can report its GPU cost.
+	void record(vk::raii::CommandBuffer& cmd);
+
+	//@brief Shuts down ImGui (device must be idle)
+	void clean();
+
+	bool isVisible() const
+	{ return m_initialized && m_visible; }
+
+	//@brief Gets the smoothed CPU time the overlay adds per visible frame
+	double getCpuOverheadMs() const
+	{ return m_cpuOverheadMs; }
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RenderCounters
+{
+	enum class Counter : uint32_t
+	{
+		Draws,
+		Instances,
+		Triangles,
+		PipelineBinds,
+		DescriptorBinds,
+		MeshBinds,
+		Barriers,
+		UploadBytes,
+		SwapchainRecreations,
+		FenceWaitUs,
+		Count
+	};
+
+	constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::Count);
+
+	//@brief Counter values accumulated over one frame
+	struct FrameCounters
+	{
+		uint64_t frame = 0;
+		std::array<uint64_t, COUNTER_COUNT> values = {};
+
+		uint64_t operator[](Counter counter) const
+		{ return values[static_cast<size_t>(counter)]; }
+	};
+
+	//@brief Keeps each counter on its own cache line so threads adding to different counters don't contend
+	struct alignas(64) Slot
+	{
+		std::atomic<uint64_t> value{ 0 };
+	};
+
+	inline std::array<Slot, COUNTER_COUNT> g_counters;
+
+	//@brief Adds to a counter of the current frame (any thread, lock-free)
+	inline void Add(Counter counter, uint64_t value = 1)
+	{
+		g_counters[static_cast<size_t>(counter)].value.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	//@brief Gets a counter's CSV column name
+	const char* GetName(Counter counter);
+
+	//@brief Takes the current frame's values and zeroes the counters for the next frame
+	FrameCounters Snapshot(uint64_t frame);
+
+	//@brief Reserves history so recording does not allocate mid-run
+	void Reserve(size_t frameCount);
+
+	//@brief Appends a snapshot to the history (main thread only)
+	void Record(const FrameCounters& counters);
+
+	//@brief Clears the history
+	void Clear();
+
+	const std::vector<FrameCounters>& GetHistory();
+
+	//@brief Gets the per-frame mean of every counter over the history
+	std::array<double, COUNTER_COUNT> GetMeans();
+
+	//@brief Writes the history as CSV, one row per frame
+	//@return False if path can't be written
+	bool WriteCsv(const std::string& path);
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include "core/profiling/gpu_profiler.h"
+
+class BindlessRegistry;
+class FrameScheduler;
+
+//@brief Compute pipeline reading its resources through the bindless set (set 1) and push constants
+struct ComputePipeline
+{
+	vk::raii::PipelineLayout layout = nullptr;
+	vk::raii::Pipeline pipeline = nullptr;
+	uint32_t pushConstantSize = 0;
+};
+
+//@brief Records compute work into per-frame command buffers and submits it on QType::Compute so it
+//@brief overlaps rasterization. Submissions signal a compute timeline semaphore with the frame number
+//@brief and can wait on the graphics timeline; graphics submissions that read its results wait through
+//@brief getWaitInfo. Buffers both queues touch must be created concurrent or have their ownership
+//@brief transferred, unless the compute family is the graphics family (then work is ordered, not overlapped).
+class AsyncCompute
+{
+private:
+	std::array<vk::raii::CommandBuffer, MAX_FRAMES_IN_FLIGHT> m_commandBuffers = { nullptr, nullptr, nullptr, nullptr };
+	vk::raii::DescriptorSetLayout m_emptyLayout = nullptr;
+	vk::raii::Semaphore m_timeline = nullptr;
+	GpuProfiler m_profiler;
+	vk::raii::Device* mp_device = nullptr;
+	vk::raii::Queue* mp_queue = nullptr;
+	BindlessRegistry* mp_bindless = nullptr;
+	FrameScheduler* mp_scheduler = nullptr;
+	// Last value submitted to the compute timeline (the frame number of the submission)
+	uint64_t m_submittedValue = 0;
+	uint32_t m_frameIndex = 0;
+	bool m_recording = false;
+
+public:
+	//@brief Allocates a command buffer per frame in flight and creates the compute timeline
+	//@param commandPool:	resettable pool of queueFamilyIndex
+	void init(
+		vk::raii::Device& device,
+		vk::raii::PhysicalDevice& physicalDevice,
+		uint32_t queueFamilyIndex,
+		vk::raii::Queue& queue,
+		vk::raii::CommandPool& commandPool,
+		BindlessRegistry& bindless,
+		FrameScheduler& scheduler,
+		bool debugLabels);
+
+	//@brief Creates a pipeline from a compiled Slang entry point
+	//@param pushConstantSize:	bytes of push constants passed to dispatch
+	ComputePipeline createPipeline(vk::ShaderModule module, const char* entryPoint, uint32_t pushConstantSize);
+
+	//@brief Starts recording the current frame's compute work (after FrameScheduler::beginFrame).
+	//@brief Waits, normally without blocking, for the compute work that last used the frame slot.
+	vk::raii::CommandBuffer& begin();
+
+	//@brief Binds pipeline and the bindless set, pushes constants and dispatches groups
+	void dispatch(const ComputePipeline& pipeline, const void* constants, uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1);
+
+	//@brief Submits the recorded work. Call only once the frame will be submitted (not cancelled).
+	//@param waitGraphicsFrame:	graphics frame whose results the work reads (0 = none)
+	//@param waitStage:			stage that waits for it
+	//@return Compute timeline value signaled when the work completes
+	uint64_t submit(uint64_t waitGraphicsFrame = 0, vk::PipelineStageFlags2 waitStage = vk::PipelineStageFlagBits2::eComputeShader);
+
+	//@brief Gets a wait on the compute timeline to add to a graphics submission
+	vk::SemaphoreSubmitInfo getWaitInfo(uint64_t value, vk::PipelineStageFlags2 stage) const;
+
+	//@brief Destroys command buffers, pipelines' shared layout and the timeline (device must be idle)
+	void clean();
+
+	//@brief Gets the command buffer being recorded (between begin and submit)
+	vk::raii::CommandBuffer& getCommandBuffer()
+	{ return m_commandBuffers[m_frameIndex]; }
+
+	uint64_t getSubmittedValue() const
+	{ return m_submittedValue; }
+
+	bool isRecording() const
+	{ return m_recording; }
+
+	//@brief Gets the profiler of compute queue passes
+	GpuProfiler& getProfiler()
+	{ return m_profiler; }
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <vector>
+
+class ImageBuffer;
+
+// Descriptor set index of the bindless set in every pipeline layout (set 0 holds per-object uniforms)
+constexpr uint32_t BINDLESS_SET = 1;
+// Requested array sizes (clamped to the device's update-after-bind limits)
+constexpr uint32_t BINDLESS_MAX_TEXTURES = 4096;
+constexpr uint32_t BINDLESS_MAX_SAMPLERS = 64;
+constexpr uint32_t BINDLESS_MAX_STORAGE_BUFFERS = 1024;
+constexpr uint32_t BINDLESS_INVALID_INDEX = UINT32_MAX;
+
+//@brief Bindings of the bindless set (match the declarations in the shaders)
+enum BindlessBinding
+{
+	Textures,
+	Samplers,
+	StorageBuffers
+};
+
+//@brief One global update-after-bind descriptor set with partially bound arrays of sampled images,
+//@brief samplers and storage buffers. Resources register once and shaders index the arrays with
+//@brief the returned slot, so the set is bound once per frame instead of once per draw.
+class BindlessRegistry
+{
+private:
+	//@brief Slot allocator for one array binding
+	struct SlotList
+	{
+		std::vector<uint32_t> freeSlots;
+		uint32_t next = 0;
+		uint32_t capacity = 0;
+
+		uint32_t acquire();
+		void release(uint32_t slot);
+	};
+
+	vk::raii::DescriptorSetLayout m_layout = nullptr;
+	vk::raii::DescriptorPool m_pool = nullptr;
+	vk::raii::DescriptorSet m_set = nullptr;
+	SlotList m_textures;
+	SlotList m_samplers;
+	SlotList m_storageBuffers;
+	vk::raii::Device* mp_device = nullptr;
+
+public:
+	//@brief Creates the layout, pool and set (requires descriptor indexing features)
+	void init(vk::raii::Device& device, vk::raii::PhysicalDevice& physicalDevice);
+
+	//@brief Writes a sampled image view into a free texture slot
+	//@return slot index used by shaders
+	uint32_t registerTexture(vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+
+	//@brief Points a registered texture slot at another view. No pending GPU work may read the slot.
+	void updateTexture(uint32_t slot, vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+
+	//@brief Registers image's view and stores the slot in the image
+	uint32_t registerTexture(ImageBuffer& image);
+
+	//@brief Writes a sampler into a free sampler slot
+	//@return slot index used by shaders
+	uint32_t registerSampler(vk::Sampler sampler);
+
+	//@brief Writes a storage buffer range into a free buffer slot
+	//@return slot index used by shaders
+	uint32_t registerStorageBuffer(vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = vk::WholeSize);
+
+	//@brief Returns slots to the registry. The caller must ensure no pending GPU work reads them.
+	void releaseTexture(uint32_t slot)
+	{ m_textures.release(slot); }
+
+	void releaseSampler(uint32_t slot)
+	{ m_samplers.release(slot); }
+
+	void releaseStorageBuffer(uint32_t slot)
+	{ m_storageBuffers.release(slot); }
+
+	//@brief Binds the set at BINDLESS_SET for every pipeline sharing layout
+	void bind(vk::raii::CommandBuffer& cmd, const vk::raii::PipelineLayout& layout, vk::PipelineBindPoint bindPoint = vk::PipelineBindPoint::eGraphics);
+
+	//@brief Destroys the set, pool and layout
+	void clean();
+
+	const vk::raii::DescriptorSetLayout& getLayout() const
+	{ return m_layout; }
+
+	vk::DescriptorSet getSet() const
+	{ return *m_set; }
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+//@brief Descriptors of a type per set, used to size new pools
+struct DescriptorPoolRatio
+{
+	vk::DescriptorType type;
+	float perSet;
+};
+
+//@brief Allocates transient descriptor sets from per-frame pools. Pools are reset whole when their
+//@brief frame slot comes around again (no per-set frees), and a frame that runs out of pool memory
+//@brief chains another pool, which is kept for later frames. Set layouts are cached by hash.
+class DescriptorAllocator
+{
+private:
+	struct FramePools
+	{
+		std::vector<vk::raii::DescriptorPool> pools;
+		// Pool currently allocated from
+		size_t current = 0;
+	};
+
+	struct CachedLayout
+	{
+		std::vector<vk::DescriptorSetLayoutBinding> bindings;
+		vk::DescriptorSetLayoutCreateFlags flags;
+		vk::raii::DescriptorSetLayout layout = nullptr;
+	};
+
+	std::array<FramePools, MAX_FRAMES_IN_FLIGHT> m_frames;
+	std::unordered_map<size_t, std::vector<CachedLayout>> m_layoutCache;
+	std::vector<DescriptorPoolRatio> m_ratios;
+	vk::raii::Device* mp_device = nullptr;
+	uint32_t m_setsPerPool = 0;
+	uint32_t m_frameIndex = 0;
+
+	//@brief Creates a pool sized for m_setsPerPool sets using m_ratios
+	vk::raii::DescriptorPool createPool();
+
+public:
+	//@brief Creates the first pool of every frame slot
+	//@param setsPerPool:	sets each chained pool can hold
+	//@param ratios:		descriptors of each type per set
+	void init(vk::raii::Device& device, uint32_t setsPerPool, std::span<const DescriptorPoolRatio> ratios);
+
+	//@brief Resets frameIndex's pools (its previous use must have completed)
+	void beginFrame(uint32_t frameIndex);
+
+	//@brief Allocates a set valid until this frame slot's next beginFrame
+	vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+
+	//@brief Gets a set layout from the cache, creating it on first use
+	vk::DescriptorSetLayout getLayout(
+		std::span<const vk::DescriptorSetLayoutBinding> bindings,
+		vk::DescriptorSetLayoutCreateFlags flags = {});
+
+	//@brief Gets pools currently owned by a frame slot
+	size_t getPoolCount(uint32_t frameIndex) const
+	{ return m_frames[frameIndex].pools.size(); }
+
+	//@brief Destroys pools and cached layouts
+	void clean();
+};
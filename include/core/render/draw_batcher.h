@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "core/geometry/mesh.h"
+#include "core/render/render_queue.h"
+#include "core/memory/frame_arena.h"
+
+//@brief Collects per-object draw requests for a frame, groups them by pipeline and mesh
+//@brief and emits one instanced RenderPacket per group. Per-instance data is written into a
+//@brief per-frame MappedBuffer bound at vertex binding 1: InstanceData for PType::Instanced,
+//@brief followed by GpuScene slots (uint32_t) for PType::Scene. Requests are collected in the
+//@brief frame's LinearArena, so recording them never touches the heap.
+class DrawBatcher
+{
+private:
+	struct DrawRequest
+	{
+		Mesh* mesh;
+		PType pipeline;
+		// Index into m_instances or m_objectSlots depending on pipeline
+		uint32_t payload;
+	};
+
+	std::array<MappedBuffer, MAX_FRAMES_IN_FLIGHT> m_instanceBuffers;
+	FrameVector<DrawRequest> m_requests;
+	FrameVector<InstanceData> m_instances;
+	FrameVector<uint32_t> m_objectSlots;
+	std::vector<SortEntry> m_entries;
+	std::vector<SortEntry> m_scratch;
+	vk::raii::Device* mp_device = nullptr;
+	uint32_t m_frameIndex = 0;
+	uint32_t m_drawCount = 0;
+	uint32_t m_instanceCount = 0;
+
+public:
+	//@brief Allocates instance buffers able to hold initialCapacity instances per frame
+	void init(vk::raii::Device& device, uint32_t initialCapacity = 1024);
+
+	//@brief Discards last frame's requests and selects frameIndex's instance buffer (its previous use must have completed)
+	//@param arena:	frame arena requests are collected in (already reset for this frame)
+	void beginFrame(uint32_t frameIndex, LinearArena& arena);
+
+	//@brief Queues one instance of mesh drawn with pipeline
+	//@param pipeline:	must be PType::Instanced, the only pipeline reading InstanceData
+	void submit(Mesh& mesh, PType pipeline, const InstanceData& instance)
+	{
+		if (pipeline != PType::Instanced)
+			throw std::runtime_error("<DrawBatcher> InstanceData draws need PType::Instanced");
+		m_requests.push_back(DrawRequest{ &mesh, pipeline, static_cast<uint32_t>(m_instances.size()) });
+		m_instances.push_back(instance);
+	}
+
+	//@brief Queues one instance of mesh whose record lives in the GpuScene (PType::Scene)
+	void submit(Mesh& mesh, uint32_t objectSlot)
+	{
+		m_requests.push_back(DrawRequest{ &mesh, PType::Scene, static_cast<uint32_t>(m_objectSlots.size()) });
+		m_objectSlots.push_back(objectSlot);
+	}
+
+	//@brief Groups queued requests, uploads their instance data, binds the instance buffer
+	//@brief and pushes one instanced packet per group into queue
+	void flush(vk::raii::CommandBuffer& cmd, RenderQueue& queue);
+
+	//@brief Destroys instance buffers
+	void destroy();
+
+	//@brief Gets instanced packets emitted by the last flush
+	uint32_t getDrawCount() const
+	{ return m_drawCount; }
+
+	//@brief Gets instances uploaded by the last flush
+	uint32_t getInstanceCount() const
+	{ return m_instanceCount; }
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+
+// Frames in flight when EngineConfig doesn't say otherwise
+constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+//@brief Paces frames on a single graphics timeline semaphore. Every frame is numbered and its
+//@brief submission signals its number, so "has the GPU finished frame N" is one counter read that
+//@brief uploads, deletion, readback and per-frame arenas can all use instead of their own fences.
+//@brief Beginning a frame only waits for the frame that last used its slot.
+class FrameScheduler
+{
+private:
+	vk::raii::Semaphore m_timeline = nullptr;
+	vk::raii::Device* mp_device = nullptr;
+	// Number of the frame being recorded (0 before the first frame)
+	uint64_t m_frameNumber = 0;
+	// Highest value seen signaled, so repeated queries can skip the semaphore
+	uint64_t m_completedValue = 0;
+	uint32_t m_framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+	uint32_t m_frameIndex = 0;
+
+public:
+	//@brief Creates the timeline semaphore
+	//@param framesInFlight:	frames the CPU may record ahead of the GPU (1 to MAX_FRAMES_IN_FLIGHT)
+	void init(vk::raii::Device& device, uint32_t framesInFlight);
+
+	//@brief Starts the next frame, blocking until the GPU has finished the frame that last used its slot
+	//@return Slot index of the new frame
+	uint32_t beginFrame();
+
+	//@brief Rewinds a frame that was never submitted (e.g. swap chain out of date), so the next
+	//@brief beginFrame reuses its number and nothing waits on a value that will not be signaled
+	void cancelFrame();
+
+	//@brief Gets the timeline signal to add to the current frame's submission
+	vk::SemaphoreSubmitInfo getSignalInfo() const;
+
+	//@brief Gets a wait on the graphics timeline for another queue's submission
+	//@param stage:	stage that waits for frame's graphics work
+	vk::SemaphoreSubmitInfo getWaitInfo(uint64_t frame, vk::PipelineStageFlags2 stage) const;
+
+	//@brief Gets the number of the last frame the GPU has finished
+	uint64_t getCompletedValue();
+
+	//@brief Determines if the GPU has finished frame
+	bool isComplete(uint64_t frame);
+
+	//@brief Blocks until the GPU has finished frame
+	void wait(uint64_t frame);
+
+	//@brief Destroys the timeline semaphore (device must be idle)
+	void clean();
+
+	uint64_t getFrameNumber() const
+	{ return m_frameNumber; }
+
+	uint32_t getFrameIndex() const
+	{ return m_frameIndex; }
+
+	uint32_t getFramesInFlight() const
+	{ return m_framesInFlight; }
+};
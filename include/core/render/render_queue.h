@@ -0,0 +1,109 @@
+#pragma once
+#include <algorithm>
+#include <span>
+#include <vector>
+#include "core/geometry/mesh.h"
+
+//@brief Render queue sort key layout, most significant field first:
+//@brief pass (4) | pipeline (8) | material (16) | mesh (16) | depth (20)
+namespace SortKey
+{
+	constexpr uint32_t PASS_SHIFT = 60;
+	constexpr uint32_t PIPELINE_SHIFT = 52;
+	constexpr uint32_t MATERIAL_SHIFT = 36;
+	constexpr uint32_t MESH_SHIFT = 20;
+	constexpr uint32_t DEPTH_BITS = 20;
+
+	//@brief Packs a sort key. Fields are truncated to their width.
+	//@param pass:	draw layer, lower passes are recorded first
+	//@param depth:	normalized view depth in [0, 1], nearer draws are recorded first
+	constexpr uint64_t Make(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth = 0.0f)
+	{
+		uint64_t quantizedDepth = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>((1u << DEPTH_BITS) - 1));
+		return (static_cast<uint64_t>(pass & 0xF) << PASS_SHIFT) |
+			(static_cast<uint64_t>(pipeline & 0xFF) << PIPELINE_SHIFT) |
+			(static_cast<uint64_t>(material & 0xFFFF) << MATERIAL_SHIFT) |
+			(static_cast<uint64_t>(mesh & 0xFFFF) << MESH_SHIFT) |
+			quantizedDepth;
+	}
+}
+
+//@brief Key and payload index sorted by RadixSort
+struct SortEntry
+{
+	uint64_t key;
+	uint32_t index;
+};
+
+// Entry count from which RadixSort splits work across threads
+constexpr size_t RADIX_PARALLEL_THRESHOLD = 1 << 16;
+
+//@brief Stable LSD radix sort on SortEntry::key with 8 bit digits. Digits shared by every
+//@brief key are skipped. Histograms and scatters are split across persistent worker threads for large inputs.
+//@param scratch:	storage of at least entries.size() (resized as needed, may be swapped with entries)
+void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+//@brief One draw submitted to a RenderQueue
+struct RenderPacket
+{
+	uint64_t key = 0;
+	Mesh* mesh = nullptr;
+	PType pipeline = PType::Standard;
+	// Set 0 and its dynamic offset (VK_NULL_HANDLE leaves set 0 untouched)
+	vk::DescriptorSet descriptorSet = VK_NULL_HANDLE;
+	uint32_t dynamicOffset = 0;
+	uint32_t instanceCount = 1;
+	uint32_t firstInstance = 0;
+};
+
+//@brief State changes and work issued by the last RenderQueue::record
+struct RenderQueueStats
+{
+	uint32_t draws = 0;
+	uint32_t pipelineBinds = 0;
+	uint32_t meshBinds = 0;
+	uint32_t descriptorBinds = 0;
+	// Triangles drawn across all instances
+	uint64_t triangles = 0;
+};
+
+//@brief Collects a frame's RenderPackets, sorts them by key and records them,
+//@brief skipping pipeline, mesh and descriptor binds that would not change state.
+class RenderQueue
+{
+private:
+	std::vector<RenderPacket> m_packets;
+	std::vector<SortEntry> m_entries;
+	std::vector<SortEntry> m_scratch;
+	RenderQueueStats m_stats;
+	bool m_sorted = false;
+
+public:
+	//@brief Reserves storage so steady-state frames do not allocate
+	void reserve(size_t packetCount);
+
+	//@brief Drops all packets (keeps capacity)
+	void clear()
+	{ m_packets.clear(); m_entries.clear(); m_sorted = false; }
+
+	//@brief Queues a packet
+	void push(const RenderPacket& packet)
+	{ m_packets.push_back(packet); m_sorted = false; }
+
+	//@brief Sorts queued packets by key (stable, so equal keys keep submission order)
+	void sort();
+
+	//@brief Records queued packets in key order (sorts first if needed)
+	//@param pipelines:	pipelines indexed by PType, sharing layout
+	void record(
+		vk::raii::CommandBuffer& cmd,
+		const vk::raii::PipelineLayout& layout,
+		std::span<const vk::Pipeline> pipelines);
+
+	size_t size() const
+	{ return m_packets.size(); }
+
+	//@brief Gets state changes issued by the last record
+	const RenderQueueStats& getStats() const
+	{ return m_stats; }
+};
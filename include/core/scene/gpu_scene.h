@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include "core/geometry/buffers.h"
+
+class BindlessRegistry;
+
+//@brief One object as stored in the GPU scene buffer (std430, matches OBJECT_RECORD_SIZE in the shaders)
+struct ObjectRecord
+{
+	glm::mat4 transform;
+	// Object space bounding sphere: xyz center, w radius
+	glm::vec4 bounds;
+	// Bindless texture slot
+	uint32_t material = 0;
+	// Mesh id (Mesh::getId)
+	uint32_t mesh = 0;
+	uint32_t pad[2] = { 0, 0 };
+};
+
+//@brief Entry of the per-frame upload list read by the scatter shader
+struct ObjectUpdate
+{
+	uint32_t slot;
+	uint32_t pad[3];
+	ObjectRecord record;
+};
+
+// Stable slot of an object in the scene buffer
+using ObjectHandle = uint32_t;
+constexpr ObjectHandle INVALID_OBJECT = UINT32_MAX;
+
+//@brief Persistent device-local buffer of ObjectRecords with stable slots. Changed records are
+//@brief collected into a compact per-frame upload list and scattered into place by a compute pass,
+//@brief so upload bandwidth follows the change rate instead of the scene size.
+class GpuScene
+{
+private:
+	struct ScatterConstants
+	{
+		uint32_t sceneBuffer;
+		uint32_t updateBuffer;
+		uint32_t updateCount;
+		uint32_t pad;
+	};
+
+	VkBuffer m_sceneBuffer = VK_NULL_HANDLE;
+	VmaAllocation m_sceneAllocation = VK_NULL_HANDLE;
+	std::array<MappedBuffer, MAX_FRAMES_IN_FLIGHT> m_uploadBuffers;
+	std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_uploadSlots;
+	std::vector<ObjectRecord> m_records;
+	std::vector<ObjectHandle> m_freeSlots;
+	std::vector<ObjectHandle> m_dirty;
+	std::vector<uint8_t> m_dirtyFlags;
+	vk::raii::DescriptorSetLayout m_emptyLayout = nullptr;
+	vk::raii::PipelineLayout m_layout = nullptr;
+	vk::raii::Pipeline m_scatterPipeline = nullptr;
+	vk::raii::Device* mp_device = nullptr;
+	BindlessRegistry* mp_bindless = nullptr;
+	uint32_t m_capacity = 0;
+	uint32_t m_objectCount = 0;
+	uint32_t m_sceneSlot = 0;
+	vk::DeviceSize m_uploadedBytes = 0;
+
+	//@brief Queues slot for the next upload
+	void markDirty(ObjectHandle slot);
+
+public:
+	//@brief Allocates the scene buffer for capacity objects and builds the scatter pipeline
+	//@param scatterShader:	module containing the scatterMain compute entry point
+	void init(vk::raii::Device& device, BindlessRegistry& bindless, vk::ShaderModule scatterShader, uint32_t capacity);
+
+	//@brief Adds an object
+	//@return stable slot, valid until remove
+	ObjectHandle add(const ObjectRecord& record);
+
+	//@brief Replaces an object's record
+	void update(ObjectHandle handle, const ObjectRecord& record);
+
+	//@brief Replaces an object's transform
+	void setTransform(ObjectHandle handle, const glm::mat4& transform);
+
+	//@brief Points every object using bindless texture slot from at slot to
+	void replaceMaterial(uint32_t from, uint32_t to);
+
+	//@brief Frees an object's slot (the slot may be reused by the next add)
+	void remove(ObjectHandle handle);
+
+	const ObjectRecord& get(ObjectHandle handle) const
+	{ return m_records[handle]; }
+
+	//@brief Records the scatter of this frame's changed records (outside of rendering)
+	void upload(vk::raii::CommandBuffer& cmd, uint32_t frameIndex);
+
+	//@brief Destroys buffers and the scatter pipeline
+	void clean();
+
+	//@brief Gets the scene buffer's bindless storage buffer slot
+	uint32_t getSceneBufferIndex() const
+	{ return m_sceneSlot; }
+
+	uint32_t getObjectCount() const
+	{ return m_objectCount; }
+
+	uint32_t getCapacity() const
+	{ return m_capacity; }
+
+	//@brief Gets bytes uploaded by the last upload
+	vk::DeviceSize getUploadedBytes() const
+	{ return m_uploadedBytes; }
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "core/geometry/buffers.h"
+#include "core/render/async_compute.h"
+
+//@brief One particle as stored in the particle buffer (matches PARTICLE_SIZE in particles.slang)
+struct Particle
+{
+	// xyz position, w remaining life in seconds
+	glm::vec4 positionLife;
+	// xyz velocity, w unused
+	glm::vec4 velocity;
+};
+
+//@brief Sample async compute workload: integrates a device-local particle buffer on the compute
+//@brief queue every frame. The particles aren't rendered, so the work is independent of graphics:
+//@brief only the compute queue touches the buffer, it needs no ownership transfers and no
+//@brief graphics submission waits on it. It exists to measure overlap with rasterization.
+class ParticleSystem
+{
+private:
+	struct SimulateConstants
+	{
+		uint32_t particleBuffer;
+		uint32_t particleCount;
+		float deltaTime;
+		float time;
+	};
+
+	ComputePipeline m_pipeline;
+	VkBuffer m_buffer = VK_NULL_HANDLE;
+	VmaAllocation m_allocation = VK_NULL_HANDLE;
+	BindlessRegistry* mp_bindless = nullptr;
+	uint32_t m_bufferSlot = 0;
+	uint32_t m_count = 0;
+	float m_time = 0.0f;
+	// Contents are undefined until the first record clears them
+	bool m_cleared = false;
+
+public:
+	//@brief Allocates count particles and builds the simulation pipeline
+	//@param simulateShader:	module containing the simulateMain compute entry point
+	void init(vk::raii::Device& device, BindlessRegistry& bindless, AsyncCompute& asyncCompute, vk::ShaderModule simulateShader, uint32_t count);
+
+	//@brief Records one simulation step into the async compute command buffer (between begin and submit)
+	void record(AsyncCompute& asyncCompute, float deltaTime);
+
+	//@brief Destroys the buffer and pipeline (device must be idle)
+	void clean();
+
+	uint32_t getCount() const
+	{ return m_count; }
+
+	//@brief Gets the particle buffer's bindless storage buffer slot
+	uint32_t getBufferIndex() const
+	{ return m_bufferSlot; }
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <random>
+#include <string>
+#include <vector>
+#include "core/geometry/mesh.h"
+#include "core/profiling/frame_stats.h"
+#include "core/scene/gpu_scene.h"
+
+class DrawBatcher;
+class RenderQueue;
+
+// Object counts run by StressSceneConfig::sweep
+constexpr uint32_t STRESS_SWEEP_COUNTS[] = { 1000, 10000, 100000, 1000000 };
+
+//@brief Options for the procedural stress scene
+struct StressSceneConfig
+{
+	// Objects spawned (0 = stress scene disabled)
+	uint32_t objectCount = 0;
+	// Unique procedural meshes shared by the objects
+	uint32_t geometryCount = 16;
+	// Unique procedural textures shared by the objects
+	uint32_t textureCount = 4;
+	// Fraction of objects respawned every frame [0, 1]
+	float churn = 0.0f;
+	// Submit objects through the DrawBatcher (one instanced draw per geometry)
+	bool instanced = false;
+	// Keep objects resident in the GpuScene and upload only changed records (implies instanced)
+	bool gpuScene = false;
+	// Fraction of objects that animate every frame [0, 1]
+	float animated = 1.0f;
+	// Keep per-object constants resident in a DynamicBuffer and rewrite only animated and
+	// respawned objects, instead of pushing every object into the uniform ring (non-instanced only)
+	bool persistentUniforms = false;
+	// Run objectCount = 1k, 10k, 100k and 1M back to back
+	bool sweep = false;
+	// Results file (one row per run is appended)
+	std::string csvPath = "stress_results.csv";
+	uint32_t seed = 1337;
+};
+
+//@brief Scaling metrics of one stress scene run
+struct StressSceneResult
+{
+	FrameTimeSummary cpu;
+	// Mean GPU frame time over the run's measured frames
+	double gpuMs = 0.0;
+	uint32_t drawCount = 0;
+	// Pipeline, mesh and descriptor binds issued per frame
+	uint32_t bindCount = 0;
+	// Mean GpuScene bytes uploaded per frame
+	uint64_t uploadBytes = 0;
+	uint64_t gpuMemoryBytes = 0;
+};
+
+//@brief Generates N objects over M geometries and K textures with configurable churn
+class StressScene
+{
+private:
+	struct Object
+	{
+		glm::vec3 position;
+		float scale;
+		float rotation;
+		float spin;
+		glm::vec4 color;
+		uint32_t geometry;
+		uint32_t texture;
+		ObjectHandle handle = INVALID_OBJECT;
+	};
+
+	StressSceneConfig m_config;
+	std::vector<Mesh> m_meshes;
+	std::vector<ImageBuffer> m_textures;
+	std::vector<Object> m_objects;
+	// Resident ObjectUniforms, one aligned slot per object (persistentUniforms)
+	DynamicBuffer m_uniforms;
+	vk::DeviceSize m_uniformStride = 0;
+	std::mt19937 m_rng;
+	bool m_active = false;
+
+	//@brief Randomizes an object in place
+	void spawn(Object& object);
+
+	//@brief Builds an object's GpuScene record
+	ObjectRecord makeRecord(const Object& object) const;
+
+	//@brief Queues object's constants for upload into its resident slot
+	void writeUniforms(uint32_t index);
+
+public:
+	//@brief Generates geometries, textures and objects
+	void init(vk::raii::Device& device, const StressSceneConfig& config);
+
+	//@brief Advances animation and respawns churn * objectCount objects.
+	//@brief In gpuScene mode only the changed objects are marked for upload.
+	void update(float dt);
+
+	//@brief Queues one packet per object. Object constants are written into uniformRing and
+	//@brief bound through objectSet (set 0, dynamic uniform buffer) with their offset.
+	//@param viewProj:	camera transform the packets' depth keys are computed with
+	void submit(
+		RenderQueue& queue,
+		vk::DescriptorSet objectSet,
+		UniformRingBuffer& uniformRing,
+		const glm::mat4& viewProj);
+
+	//@brief Queues one packet per object reading its resident constants (persistentUniforms)
+	//@param uniformSet:	set 0 viewing getUniformBuffer as a dynamic uniform buffer
+	void submit(RenderQueue& queue, vk::DescriptorSet uniformSet, const glm::mat4& viewProj);
+
+	//@brief Uploads this frame's changed constants into frameIndex's copy (outside of rendering)
+	void flushUniforms(vk::raii::CommandBuffer& cmd, uint32_t frameIndex);
+
+	//@brief True if object constants are resident instead of streamed through the uniform ring
+	bool usesPersistentUniforms() const
+	{ return m_uniformStride > 0; }
+
+	VkBuffer getUniformBuffer()
+	{ return m_uniforms.getBuffer(); }
+
+	//@brief Queues every object into batcher with the instanced pipeline
+	//@brief (or by GpuScene slot with the scene pipeline in gpuScene mode)
+	void submit(DrawBatcher& batcher);
+
+	//@brief Appends a result row to config.csvPath (writes the header for new files)
+	void writeCsvRow(const StressSceneResult& result) const;
+
+	//@brief Retires GPU resources to the engine's deletion queue
+	void destroy();
+
+	bool isActive() const
+	{ return m_active; }
+
+	const StressSceneConfig& getConfig() const
+	{ return m_config; }
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include "core/profiling/frame_stats.h"
+
+//@brief How frames are presented and paced
+enum class PresentPolicy : uint32_t
+{
+	// Mailbox (or immediate), renders as fast as possible
+	Uncapped,
+	// FIFO, one frame per refresh
+	Vsync,
+	// FIFO with at most one frame queued for display (VK_KHR_present_wait, else plain FIFO)
+	LowLatency,
+	// Uncapped present mode with the CPU limited to PresentConfig::fpsCap
+	Capped
+};
+
+//@brief Presentation options
+struct PresentConfig
+{
+	PresentPolicy policy = PresentPolicy::Uncapped;
+	// Frame rate of the Capped policy
+	double fpsCap = 60.0;
+	// Frame rate cap while the window is unfocused (0 = unthrottled)
+	double backgroundFps = 30.0;
+};
+
+// Presents tracked for latency at once
+constexpr uint32_t PACER_MAX_PENDING = 8;
+// Remaining time under which the limiter spins instead of sleeping (covers OS sleep granularity)
+constexpr std::chrono::microseconds PACER_SPIN_THRESHOLD{ 2000 };
+// Longest LowLatency blocks on a present, so an occluded window can't hang the loop
+constexpr uint64_t PACER_PRESENT_TIMEOUT_NS = 100'000'000;
+// Event wait while the window is minimized
+constexpr int32_t PACER_MINIMIZED_WAIT_MS = 100;
+
+//@brief Paces the main loop. Applies the policy's frame cap (and the background cap while
+//@brief unfocused) with a sleep-then-spin limiter, keeps LowLatency at one queued present through
+//@brief VK_KHR_present_wait, and measures input-to-photon latency as the time from a frame's input
+//@brief being sampled to its present completing (exact under LowLatency, within a frame otherwise).
+class FramePacer
+{
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct PendingPresent
+	{
+		uint64_t presentId = 0;
+		Clock::time_point inputTime;
+	};
+
+	PresentConfig m_config;
+	std::array<PendingPresent, PACER_MAX_PENDING> m_pending = {};
+	uint32_t m_pendingBegin = 0;
+	uint32_t m_pendingCount = 0;
+	Clock::time_point m_nextFrame;
+	Clock::time_point m_inputTime;
+	FrameStats m_latency;
+	double m_lastLatencyMs = 0.0;
+	// VK_KHR_present_id and VK_KHR_present_wait are enabled
+	bool m_presentWait = false;
+
+	//@brief Sleeps, then spins through the last PACER_SPIN_THRESHOLD, until the next frame of fps is due
+	void limit(double fps);
+
+	//@brief Waits up to timeout for present and records its latency
+	//@return False if it hasn't completed (or the swap chain is out of date)
+	bool waitForPresent(vk::raii::SwapchainKHR& swapChain, const PendingPresent& present, uint64_t timeout);
+
+	//@brief Records the latency of every tracked present that completed
+	//@param block:	wait (bounded) for the newest present and drop every older one, instead of
+	//@param		only polling
+	void collectPresents(vk::raii::SwapchainKHR& swapChain, bool block);
+
+public:
+	//@param presentWait:	VK_KHR_present_id and VK_KHR_present_wait are enabled on the device
+	void init(const PresentConfig& config, bool presentWait);
+
+	//@brief Waits until the next frame should start. Call before sampling input.
+	void pace(vk::raii::SwapchainKHR& swapChain, bool focused);
+
+	//@brief Marks input as sampled for the frame about to be recorded
+	void markInput()
+	{ m_inputTime = Clock::now(); }
+
+	//@brief Tracks a present for latency (ignored without present wait)
+	//@param presentId:	id chained to the present through vk::PresentIdKHR
+	void onPresent(uint64_t presentId);
+
+	//@brief Forgets presents made to a retired swap chain (ids are per swap chain)
+	void onSwapChainRecreated()
+	{ m_pendingCount = 0; }
+
+	//@brief Clears recorded latencies
+	void clearStats()
+	{ m_latency.clear(); }
+
+	bool usesPresentWait() const
+	{ return m_presentWait; }
+
+	const PresentConfig& getConfig() const
+	{ return m_config; }
+
+	//@brief Gets recorded input-to-photon latencies (milliseconds)
+	const FrameStats& getLatencyStats() const
+	{ return m_latency; }
+
+	double getLastLatencyMs() const
+	{ return m_lastLatencyMs; }
+};
@@ -20,6 +20,12 @@ public:
 	void close() { m_open = false; }
 	//@brief Checks and responds to SDL events
 	void checkEvents();
+	//@brief Blocks until an event arrives or timeoutMs passes, then responds to all pending events
+	void waitEvents(int32_t timeoutMs);
+	//@brief Returns if window is minimized
+	bool isMinimized();
+	//@brief Returns if window has input focus
+	bool isFocused();
 	//@brief Returns if window is open
 	bool isOpen() { return m_open; }
 	//@brief Returns SDL window
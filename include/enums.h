@@ -7,4 +7,23 @@ enum QType
 	Compute,
 	Transfer,
 	Present
+};
+
+// Graphics Pipeline Types
+enum PType
+{
+	Standard,
+	Instanced,
+	Scene,
+	PTypeCount
+};
+
+// Memory Pool Types (see Allocator; MTypeCount selects the default VMA pools)
+enum MType
+{
+	MeshMemory,
+	TextureMemory,
+	StagingMemory,
+	UniformMemory,
+	MTypeCount
 };
\ No newline at end of file
@@ -1,9 +1,141 @@
 #include <iostream>
+#include <string>
 #include "core/engine.h"
 
-int main() {
+static void PrintUsage() {
+    std::cerr << "Usage: TheWheel [--headless] [--frames N] [--width W] [--height H]\n"
+              << "                [--stress N] [--geometries M] [--textures K] [--churn F]\n"
+              << "                [--instanced] [--gpu-scene] [--animated F] [--persistent-uniforms]\n"
+              << "                [--sweep] [--csv path] [--defrag] [--memory-json path]\n"
+              << "                [--overlay] [--counters-csv path] [--frames-in-flight N]\n"
+              << "                [--present uncapped|vsync|low-latency|capped] [--fps-cap F] [--background-fps F]\n"
+              << "                [--device index|name] [--async-particles N]\n"
+              << "                [--trace path] [--trace-format chrome|perfetto]" << std::endl;
+}
+
+//@brief Parses a --present value
+static PresentPolicy ParsePresentPolicy(const std::string& name) {
+    if (name == "uncapped")
+        return PresentPolicy::Uncapped;
+    if (name == "vsync")
+        return PresentPolicy::Vsync;
+    if (name == "low-latency")
+        return PresentPolicy::LowLatency;
+    if (name == "capped")
+        return PresentPolicy::Capped;
+    throw std::invalid_argument("unknown present policy " + name);
+}
+
+//@brief Parses a --trace-format value
+static Profiler::TraceFormat ParseTraceFormat(const std::string& name) {
+    if (name == "chrome")
+        return Profiler::TraceFormat::ChromeJson;
+    if (name == "perfetto")
+        return Profiler::TraceFormat::PerfettoJson;
+    throw std::invalid_argument("unknown trace format " + name);
+}
+
+//@brief Parses command line options into an EngineConfig
+static EngineConfig ParseArgs(int argc, char** argv) {
+    EngineConfig config;
+    bool backgroundFpsSet = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc)
+                throw std::invalid_argument("missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "--headless")
+            config.headless = true;
+        else if (arg == "--frames")
+            config.frameCount = static_cast<uint32_t>(std::stoul(next()));
+        else if (arg == "--width")
+            config.width = static_cast<uint32_t>(std::stoul(next()));
+        else if (arg == "--height")
+            config.height = static_cast<uint32_t>(std::stoul(next()));
+        else if (arg == "--stress")
+            config.stress.objectCount = static_cast<uint32_t>(std::stoul(next()));
+        else if (arg == "--geometries")
+            config.stress.geometryCount = static_cast<uint32_t>(std::stoul(next()));
+        else if (arg == "--textures")
+            config.stress.textureCount = static_cast<uint32_t>(std::stoul(next()));
+        else if (arg == "--churn")
+            config.stress.churn = std::stof(next());
+        else if (arg == "--instanced")
+            config.stress.instanced = true;
+        else if (arg == "--gpu-scene")
+            config.stress.gpuScene = true;
+        else if (arg == "--animated")
+            config.stress.animated = std::stof(next());
+        else if (arg == "--persistent-uniforms")
+            config.stress.persistentUniforms = true;
+        else if (arg == "--sweep")
+            config.stress.sweep = true;
+        else if (arg == "--csv")
+            config.stress.csvPath = next();
+        else if (arg == "--defrag")
+            config.defrag.enabled = true;
+        else if (arg == "--memory-json")
+            config.memoryReportPath = next();
+        else if (arg == "--overlay")
+            config.overlay = true;
+        else if (arg == "--counters-csv")
+            config.countersCsvPath = next();
+        else if (arg == "--frames-in-flight")
+            config.framesInFlight = static_cast<uint32_t>(std::stoul(next()));
+        else if (arg == "--present")
+            config.present.policy = ParsePresentPolicy(next());
+        else if (arg == "--fps-cap") {
+            config.present.policy = PresentPolicy::Capped;
+            config.present.fpsCap = std::stod(next());
+        }
+        else if (arg == "--device")
+            config.device = next();
+        else if (arg == "--async-particles")
+            config.asyncParticles = static_cast<uint32_t>(std::stoul(next()));
+        else if (arg == "--trace")
+            config.tracePath = next();
+        else if (arg == "--trace-format")
+            config.traceFormat = ParseTraceFormat(next());
+        else if (arg == "--background-fps") {
+            config.present.backgroundFps = std::stod(next());
+            backgroundFpsSet = true;
+        }
+        else
+            throw std::invalid_argument("unknown argument " + arg);
+    }
+
+    if (config.stress.sweep && config.stress.objectCount == 0)
+        config.stress.objectCount = 1000;
+
+    // Stress runs need a finite length to produce results
+    if (config.stress.objectCount > 0 && config.frameCount == 0) {
+        config.frameCount = 300;
+        config.warmupFrames = 30;
+    }
+
+    // Measurements must not depend on whether the window has focus
+    if (config.stress.objectCount > 0 && !backgroundFpsSet)
+        config.present.backgroundFps = 0.0;
+
+    return config;
+}
+
+int main(int argc, char** argv) {
     Core& app = Core::GetInstance();
 
+    try {
+        app.setConfig(ParseArgs(argc, argv));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "TheWheel: " << e.what() << std::endl;
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
     try {
         app.run();
     }
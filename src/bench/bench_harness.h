@@ -0,0 +1,84 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "core/profiling/frame_stats.h"
+
+//@brief Timing summary for one microbenchmark (nanoseconds per iteration)
+struct BenchResult
+{
+	std::string name;
+	uint32_t iterations = 0;
+	double meanNs = 0.0;
+	double minNs = 0.0;
+	double p50Ns = 0.0;
+	double p95Ns = 0.0;
+	double maxNs = 0.0;
+};
+
+//@brief Times fn for the given number of iterations after a short warmup
+template<typename Fn>
+BenchResult RunBench(const std::string& name, uint32_t iterations, Fn&& fn)
+{
+	for (uint32_t i = 0; i < std::min(iterations, 3u); i++)
+		fn();
+
+	FrameStats stats;
+	stats.reserve(iterations);
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		fn();
+		auto end = std::chrono::steady_clock::now();
+		stats.record(std::chrono::duration<double, std::milli>(end - begin).count());
+	}
+
+	FrameTimeSummary s = stats.summarize();
+	return BenchResult{
+		.name = name,
+		.iterations = iterations,
+		.meanNs = s.mean * 1e6,
+		.minNs = s.min * 1e6,
+		.p50Ns = s.p50 * 1e6,
+		.p95Ns = s.p95 * 1e6,
+		.maxNs = s.max * 1e6
+	};
+}
+
+//@brief Writes str as a quoted JSON string
+inline void WriteJsonString(std::ostream& out, const std::string& str)
+{
+	static constexpr char HEX[] = "0123456789abcdef";
+	out << '"';
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+			out << '\\' << c;
+		else if (static_cast<unsigned char>(c) < 0x20)
+			out << "\\u00" << HEX[(c >> 4) & 0xf] << HEX[c & 0xf];
+		else
+			out << c;
+	}
+	out << '"';
+}
+
+//@brief Writes results as {"context":{...},"benchmarks":[...]}
+inline void WriteBenchJson(std::ostream& out, const std::string& deviceName, const std::vector<BenchResult>& results)
+{
+	out << "{\n  \"context\": {\"device\": ";
+	WriteJsonString(out, deviceName);
+	out << "},\n  \"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchResult& r = results[i];
+		out << "    {\"name\": ";
+		WriteJsonString(out, r.name);
+		out << ", \"iterations\": " << r.iterations
+			<< ", \"mean_ns\": " << r.meanNs << ", \"min_ns\": " << r.minNs
+			<< ", \"p50_ns\": " << r.p50Ns << ", \"p95_ns\": " << r.p95Ns
+			<< ", \"max_ns\": " << r.maxNs << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n}" << std::endl;
+}
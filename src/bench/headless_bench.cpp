@@ -0,0 +1,71 @@
+#include <iostream>
+#include <string>
+#include "core/engine.h"
+
+// Usage: TheWheelBench [--frames N] [--warmup N] [--width W] [--height H] [--frames-in-flight N] [--async-particles N] [--device index|name] [--counters-csv path]
+int main(int argc, char** argv) {
+    EngineConfig config{
+        .headless = true,
+        .width = 1920,
+        .height = 1080,
+        .frameCount = 1000,
+        .warmupFrames = 30
+    };
+
+    try {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string arg = argv[i];
+            if (arg == "--counters-csv") {
+                config.countersCsvPath = argv[i + 1];
+                continue;
+            }
+            if (arg == "--device") {
+                config.device = argv[i + 1];
+                continue;
+            }
+
+            uint32_t value = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+
+            if (arg == "--frames")
+                config.frameCount = value;
+            else if (arg == "--warmup")
+                config.warmupFrames = value;
+            else if (arg == "--width")
+                config.width = value;
+            else if (arg == "--height")
+                config.height = value;
+            else if (arg == "--frames-in-flight")
+                config.framesInFlight = value;
+            else if (arg == "--async-particles")
+                config.asyncParticles = value;
+            else
+                throw std::invalid_argument("unknown argument " + arg);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "TheWheelBench: " << e.what() << std::endl;
+        std::cerr << "Usage: TheWheelBench [--frames N] [--warmup N] [--width W] [--height H] [--frames-in-flight N] [--async-particles N] [--device index|name] [--counters-csv path]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Core& app = Core::GetInstance();
+    app.setConfig(config);
+
+    try {
+        app.run();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    app.getFrameStats().print(std::cout, "Headless Frame Time");
+    std::cout << "heap allocations/frame: " << app.getHeapAllocationsPerFrame() << std::endl;
+    if (config.asyncParticles > 0)
+        app.getComputeOverlapStats().print(std::cout, "Async Compute Overlap");
+
+    std::array<double, RenderCounters::COUNTER_COUNT> means = RenderCounters::GetMeans();
+    for (size_t i = 0; i < RenderCounters::COUNTER_COUNT; i++)
+        std::cout << RenderCounters::GetName(static_cast<RenderCounters::Counter>(i)) << "/frame: " << means[i] << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <SDL3/SDL_events.h>
+#include "core/engine.h"
+#include "core/geometry/buffers.h"
+#include "core/system/event_handler.h"
+#include "read_file.h"
+#include "bench_harness.h"
+
+static std::string bench_root_dir = std::filesystem::path(__FILE__).parent_path().parent_path().parent_path().string();
+
+static unsigned int eventCounter = 0;
+static void CountEvent(SDL_Event*) { eventCounter++; }
+
+//@brief Builds an n x n grid of quads (uint32 indices so large grids fit)
+static void MakeGrid(uint32_t n, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    vertices.clear();
+    indices.clear();
+    vertices.reserve((n + 1) * (n + 1));
+    indices.reserve(n * n * 6);
+
+    for (uint32_t y = 0; y <= n; y++)
+        for (uint32_t x = 0; x <= n; x++)
+            vertices.emplace_back(glm::vec2(x / float(n) - 0.5f, y / float(n) - 0.5f), glm::vec3(x / float(n), y / float(n), 1.0f));
+
+    for (uint32_t y = 0; y < n; y++)
+    {
+        for (uint32_t x = 0; x < n; x++)
+        {
+            uint32_t i = y * (n + 1) + x;
+            indices.insert(indices.end(), { i, i + 1, i + n + 2, i + n + 2, i + n + 1, i });
+        }
+    }
+}
+
+//@brief Compares RadixSort against std::stable_sort on inputs below and above the parallel
+//@brief threshold. Throws on the first mismatch (keys or payload order of equal keys).
+static void CheckRadixSort(std::mt19937& rng)
+{
+    std::uniform_int_distribution<uint64_t> random64;
+    const std::pair<const char*, std::function<uint64_t(uint32_t)>> patterns[] = {
+        { "random", [&](uint32_t) { return random64(rng); } },
+        { "equal", [](uint32_t) { return uint64_t(0x0123456789ABCDEF); } },
+        // Only the top two digits vary, so every lower digit is skipped
+        { "high bytes", [&](uint32_t) { return (random64(rng) & 0xFFFF000000000000ull) | 0x0000A5A5A5A5A5A5ull; } }
+    };
+    const uint32_t counts[] = { 1000u, uint32_t(RADIX_PARALLEL_THRESHOLD - 1), uint32_t(RADIX_PARALLEL_THRESHOLD * 4) };
+
+    std::vector<SortEntry> entries, expected, scratch;
+    for (const auto& [label, makeKey] : patterns)
+    {
+        for (uint32_t count : counts)
+        {
+            entries.resize(count);
+            for (uint32_t i = 0; i < count; i++)
+                entries[i] = SortEntry{ makeKey(i), i };
+            expected = entries;
+            std::stable_sort(expected.begin(), expected.end(), [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+            RadixSort(entries, scratch);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (entries[i].key != expected[i].key || entries[i].index != expected[i].index)
+                    throw std::runtime_error("RadixSort mismatch (" + std::string(label) + ", " + std::to_string(count) +
+                        " entries) at " + std::to_string(i));
+            }
+        }
+    }
+}
+
+// Results file when --out is not given; stdout carries the engine's device info
+constexpr const char* DEFAULT_OUT_PATH = "micro_bench.json";
+
+// Usage: TheWheelMicroBench [--out results.json]
+int main(int argc, char** argv) {
+    std::string outPath = DEFAULT_OUT_PATH;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc)
+            outPath = argv[++i];
+        else {
+            std::cerr << "TheWheelMicroBench: unknown argument " << arg << std::endl;
+            std::cerr << "Usage: TheWheelMicroBench [--out results.json]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Core& core = Core::GetInstance();
+    core.setConfig(EngineConfig{ .headless = true, .width = 64, .height = 64 });
+
+    std::vector<BenchResult> results;
+    std::string deviceName;
+
+    try {
+        core.init();
+        vk::raii::Device& device = core.getDevice();
+        deviceName = core.getPhysicalDevice().getProperties().deviceName.data();
+
+        //-----Buffer::Create-----
+        for (vk::DeviceSize size : { vk::DeviceSize(64) << 10, vk::DeviceSize(16) << 20 })
+        {
+            results.push_back(RunBench("Buffer::Create/device/" + std::to_string(size >> 10) + "KiB", 200, [&] {
+                VkBuffer buffer = VK_NULL_HANDLE;
+                VmaAllocation allocation = Buffer::Create(
+                    device,
+                    buffer,
+                    size,
+                    VkBufferUsageFlagBits::VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                    0,
+                    VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+                vmaDestroyBuffer(Allocator::GetAllocator(), buffer, allocation);
+            }));
+        }
+
+        //-----VIBuffer::initBuffer-----
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        const std::pair<const char*, uint32_t> meshSizes[] = { { "small", 1 }, { "medium", 64 }, { "large", 512 } };
+        for (const auto& [label, n] : meshSizes)
+        {
+            MakeGrid(n, vertices, indices);
+            results.push_back(RunBench(std::string("VIBuffer::initBuffer/") + label, n >= 512 ? 20 : 200, [&] {
+                VIBuffer buffer;
+                buffer.initBuffer(device, &vertices, &indices);
+                buffer.destroy();
+            }));
+        }
+
+        //-----ImageBuffer::initBuffer-----
+        std::string texturePath = bench_root_dir + "/assets/ktx2/holy_cow.ktx2";
+        results.push_back(RunBench("ImageBuffer::initBuffer/holy_cow", 20, [&] {
+            ImageBuffer image;
+            image.initBuffer(device, texturePath.c_str());
+            image.destroy();
+        }));
+
+        //-----EventHandler::InvokeEventSubs-----
+        constexpr uint32_t DISPATCHES = 10000;
+        for (int i = 0; i < 8; i++)
+            EventHandler::SubToEvent(SDL_EVENT_USER, CountEvent);
+        SDL_Event event{};
+        event.type = SDL_EVENT_USER;
+        BenchResult dispatch = RunBench("EventHandler::InvokeEventSubs/8subs", 100, [&] {
+            for (uint32_t i = 0; i < DISPATCHES; i++)
+                EventHandler::InvokeEventSubs(&event);
+        });
+        // Report per dispatch instead of per batch
+        for (double* v : { &dispatch.meanNs, &dispatch.minNs, &dispatch.p50Ns, &dispatch.p95Ns, &dispatch.maxNs })
+            *v /= DISPATCHES;
+        results.push_back(dispatch);
+
+        //-----ReadFile-----
+        std::string tempPath = (std::filesystem::temp_directory_path() / "thewheel_readfile_bench.bin").string();
+        {
+            std::ofstream tempFile(tempPath, std::ios::binary | std::ios::trunc);
+            std::vector<char> payload(4 << 20, 'w');
+            tempFile.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        }
+        results.push_back(RunBench("ReadFile/4MiB", 100, [&] {
+            std::vector<char> data = ReadFile(tempPath);
+            if (data.empty())
+                throw std::runtime_error("ReadFile returned no data");
+        }));
+        std::filesystem::remove(tempPath);
+
+        //-----RadixSort (render queue keys; includes restoring the unsorted input)-----
+        std::mt19937 rng(7);
+        CheckRadixSort(rng);
+        for (uint32_t count : { 10000u, 1000000u })
+        {
+            std::vector<SortEntry> unsorted(count), entries, scratch;
+            for (uint32_t i = 0; i < count; i++)
+                unsorted[i] = SortEntry{ SortKey::Make(rng() % 2, rng() % PTypeCount, rng() % 64, rng() % 256, (rng() % 1000) / 1000.0f), i };
+            results.push_back(RunBench("RadixSort/" + std::to_string(count), count >= 1000000 ? 20 : 200, [&] {
+                entries = unsorted;
+                RadixSort(entries, scratch);
+            }));
+        }
+
+        core.getDevice().waitIdle();
+        core.clean();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream out(outPath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "TheWheelMicroBench: failed to open " << outPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    WriteBenchJson(out, deviceName, results);
+    if (!out.good()) {
+        std::cerr << "TheWheelMicroBench: failed to write " << outPath << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << "Benchmark results written to " << outPath << std::endl;
+    return EXIT_SUCCESS;
+}
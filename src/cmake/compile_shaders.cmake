@@ -30,18 +30,19 @@ macro(add_slang_shader_target TARGET)
     set(ENTRY_POINTS "")
     if(NOT SHADER_ENTRY_POINTS)
         list(APPEND ENTRY_POINTS -entry vertMain -entry fragMain)
-    elseif()
+    else()
         foreach(e IN LISTS SHADER_ENTRY_POINTS)
             list(APPEND ENTRY_POINTS -entry "${e}")
         endforeach()
     endif()
   
+    # Per-target names so several shader files can be compiled
     if(NOT SHADER_ENTRY_POINTS)
-        create_spv(VERT_SPV FILE_NAME ${FILE_NAME}.vert)
-        create_spv(FRAG_SPV FILE_NAME ${FILE_NAME}.frag)
-        add_custom_target(${TARGET} DEPENDS VERT_SPV FRAG_SPV)
+        create_spv(${TARGET}_VERT_SPV FILE_NAME ${FILE_NAME}.vert)
+        create_spv(${TARGET}_FRAG_SPV FILE_NAME ${FILE_NAME}.frag)
+        add_custom_target(${TARGET} DEPENDS ${TARGET}_VERT_SPV ${TARGET}_FRAG_SPV)
     else()
-        create_spv(COMPILED_SPV FILE_NAME ${FILE_NAME})
-        add_custom_target(${TARGET} DEPENDS COMPILED_SPV)
+        create_spv(${TARGET}_SPV FILE_NAME ${FILE_NAME})
+        add_custom_target(${TARGET} DEPENDS ${TARGET}_SPV)
     endif()
 endmacro()
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "read_file.h"
 #include "core/engine.h"
 
+#include <cctype>
 #include <filesystem>
 #include <ktx.h>
 #include <ktxvulkan.h>
@@ -11,6 +12,8 @@
 #include "core/system/window.h"
 
 #include "core/geometry/mesh.h"
+#include "core/profiling/cpu_profiler.h"
+#include "core/profiling/render_counters.h"
 #include "core/renderer.h"
 
 Renderer* pRenderer = nullptr;
@@ -27,13 +30,13 @@ const std::vector<uint16_t> index_data =
 { 0, 1, 2, 2, 3, 0 };
 
 UniformBufferObject constants;
-glm::mat4 render_matrix;
+glm::mat4 view_proj_matrix;
 
 ImageBuffer triIB;
+// 1x1 white texture registered first, so bindless texture slot 0 is always valid
+ImageBuffer defaultIB;
 Mesh triangle;
 
-constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
 std::string root_dir = std::filesystem::path(__FILE__).parent_path().parent_path().parent_path().string();
 
 const std::vector<const char*> VALIDATION_LAYERS = {
@@ -88,6 +91,7 @@ void Core::transitionImageLayout(
         .pImageMemoryBarriers = &barrier
     };
     m_commandBuffers[QType::Graphics][m_frameIndex].pipelineBarrier2(dependencyInfo);
+    RenderCounters::Add(RenderCounters::Counter::Barriers);
 }
 
 void Core::setupDebugMessenger()
@@ -102,28 +106,69 @@ void Core::setupDebugMessenger()
     m_debugMessenger = m_instance.createDebugUtilsMessengerEXT(debugUtilsMessengerCreateInfoEXT);
 }
 
+//@brief Determines if a device override (index or case-insensitive name substring) names a device
+static bool MatchesDeviceOverride(const std::string& override, uint32_t index, std::string_view name)
+{
+    if (std::ranges::all_of(override, [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }))
+        return std::stoul(override) == index;
+
+    auto lower = [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); };
+    auto match = std::ranges::search(name, override, {}, lower, lower);
+    return !match.empty();
+}
+
 void Core::selectPhysicalDevices()
 {
-    vk::raii::PhysicalDevice physicalDevice = m_instance.enumeratePhysicalDevices().front();
     auto devices = m_instance.enumeratePhysicalDevices();
+    if (devices.empty())
+        throw std::runtime_error("<Core> failed to find GPUs with Vulkan support");
 
-    try 
+    // The command line wins over the environment
+    std::string override = m_config.device;
+    if (const char* environmentDevice = std::getenv("THEWHEEL_DEVICE"); override.empty() && environmentDevice)
+        override = environmentDevice;
+
+    if constexpr (DISPLAY_VULKAN_INFO)
+        std::cout << "-----Devices--------" << std::endl;
+
+    std::string rejections;
+    int64_t bestScore = -1;
+    for (uint32_t i = 0; i < devices.size(); i++)
     {
-        if (devices.empty()) {
-            throw std::runtime_error("failed to find GPUs with Vulkan support!");
+        std::string name = devices[i].getProperties().deviceName;
+        std::string rejection;
+        int64_t score = scorePhysicalDevice(devices[i], rejection);
+
+        if (!override.empty() && !MatchesDeviceOverride(override, i, name))
+        {
+            score = -1;
+            rejection = "not selected by device override \"" + override + "\"";
         }
 
         if constexpr (DISPLAY_VULKAN_INFO)
-            std::cout << "-----Devices--------" << std::endl;
-        for (const auto& device : devices)
-            if (suitableDiscreteGPU(device)) 
-                break;
-        if constexpr (DISPLAY_VULKAN_INFO)
-            std::cout << "--------------------" << std::endl;
+        {
+            if (score < 0)
+                std::cout << i << ": " << name << " rejected: " << rejection << std::endl;
+            else
+                std::cout << i << ": " << name << " score " << score << std::endl;
+        }
+
+        if (score < 0)
+            rejections += "\n  " + std::to_string(i) + ": " + name + ": " + rejection;
+        else if (score > bestScore)
+        {
+            bestScore = score;
+            m_dGPU = devices[i];
+        }
     }
-    catch (const std::exception& err) {
-        std::cerr << "Device Setup Error: " << err.what() << std::endl;
-        assert(0);
+
+    if (!*m_dGPU)
+        throw std::runtime_error("<Core> no suitable Vulkan device:" + rejections);
+
+    if constexpr (DISPLAY_VULKAN_INFO)
+    {
+        std::cout << "Selected: " << m_dGPU.getProperties().deviceName << std::endl;
+        std::cout << "--------------------" << std::endl;
     }
 }
 
@@ -140,11 +185,6 @@ void Core::setupLogicalDevice()
     m_familyIndices[QType::Graphics] = m_familyIndices[QType::Compute] = 
         m_familyIndices[QType::Transfer] = m_familyIndices[QType::Present] = queueFamilyProperties.size();
     
-    // Query surface capabilities, available formats and presentation modes
-    auto surfaceCapabilities = m_dGPU.getSurfaceCapabilitiesKHR(m_surface);
-    std::vector<vk::SurfaceFormatKHR> availableFormats = m_dGPU.getSurfaceFormatsKHR(m_surface);
-    std::vector<vk::PresentModeKHR> availablePresentModes = m_dGPU.getSurfacePresentModesKHR(m_surface);
-
     // Find graphics, compute, and transfer queue index
     for (size_t i = 0; i < queueFamilyProperties.size(); i++)
     {
@@ -179,16 +219,54 @@ void Core::setupLogicalDevice()
     };
 
     std::vector<const char*> deviceExtensions = {
-        vk::KHRSwapchainExtensionName,
         vk::KHRSpirv14ExtensionName,
         vk::KHRSynchronization2ExtensionName,
         vk::KHRCreateRenderpass2ExtensionName,
         vk::KHRShaderDrawParametersExtensionName
     };
 
+    // Headless rendering never presents, so the graphics queue stands in for present
+    if (m_config.headless)
+        m_familyIndices[QType::Present] = m_familyIndices[QType::Graphics];
+    else
+        deviceExtensions.push_back(vk::KHRSwapchainExtensionName);
+
+    auto availableExtensions = m_dGPU.enumerateDeviceExtensionProperties();
+    auto hasExtension = [&availableExtensions](const char* name) {
+        return std::ranges::any_of(availableExtensions,
+            [name](const vk::ExtensionProperties& extension) { return strcmp(extension.extensionName, name) == 0; });
+    };
+
+    // Exact heap budgets for memory telemetry when the driver reports them
+    m_memoryBudget = hasExtension(vk::EXTMemoryBudgetExtensionName);
+    if (m_memoryBudget)
+        deviceExtensions.push_back(vk::EXTMemoryBudgetExtensionName);
+
+    // Present pacing for LowLatency and input-to-photon latency measurement
+    if (!m_config.headless && hasExtension(vk::KHRPresentIdExtensionName) && hasExtension(vk::KHRPresentWaitExtensionName))
+    {
+        auto presentFeatures = m_dGPU.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR, vk::PhysicalDevicePresentWaitFeaturesKHR>();
+        m_presentWait = presentFeatures.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId &&
+            presentFeatures.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait;
+    }
+    if (m_presentWait)
+    {
+        deviceExtensions.push_back(vk::KHRPresentIdExtensionName);
+        deviceExtensions.push_back(vk::KHRPresentWaitExtensionName);
+    }
+
+    // Present fences tell when a retired swap chain and its semaphores are no longer used
+    if (m_surfaceMaintenance && hasExtension(vk::EXTSwapchainMaintenance1ExtensionName))
+    {
+        auto maintenanceFeatures = m_dGPU.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceSwapchainMaintenance1FeaturesEXT>();
+        m_presentFences = maintenanceFeatures.get<vk::PhysicalDeviceSwapchainMaintenance1FeaturesEXT>().swapchainMaintenance1;
+    }
+    if (m_presentFences)
+        deviceExtensions.push_back(vk::EXTSwapchainMaintenance1ExtensionName);
+
     // determine a queueFamilyIndex that supports present
     // first check if the graphicsIndex is good enough
-    if (m_dGPU.getSurfaceSupportKHR(m_familyIndices[QType::Graphics], *m_surface))
+    if (!m_config.headless && m_dGPU.getSurfaceSupportKHR(m_familyIndices[QType::Graphics], *m_surface))
         m_familyIndices[QType::Present] = m_familyIndices[QType::Graphics];
 
     if (m_familyIndices[QType::Present] == queueFamilyProperties.size())
@@ -278,15 +356,48 @@ void Core::setupLogicalDevice()
 
     deviceQueueCI[QType::Graphics].setQueueCount(currQueueIndex);
 
-    // query for Vulkan 1.3 features
+    // query for Vulkan 1.2 descriptor indexing (bindless) and Vulkan 1.3 features
+    auto supported = m_dGPU.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+    const vk::PhysicalDeviceVulkan12Features& supported12 = supported.get<vk::PhysicalDeviceVulkan12Features>();
+    if (!supported12.descriptorIndexing || !supported12.runtimeDescriptorArray || !supported12.descriptorBindingPartiallyBound ||
+        !supported12.descriptorBindingSampledImageUpdateAfterBind || !supported12.descriptorBindingStorageBufferUpdateAfterBind ||
+        !supported12.descriptorBindingUpdateUnusedWhilePending || !supported12.shaderSampledImageArrayNonUniformIndexing)
+    {
+        throw std::runtime_error("<Core> device does not support the descriptor indexing features required for bindless resources");
+    }
+
     auto features = m_dGPU.getFeatures2();
+    vk::PhysicalDeviceVulkan12Features vulkan12Features;
     vk::PhysicalDeviceVulkan13Features vulkan13Features;
     vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures;
+    vk::PhysicalDevicePresentIdFeaturesKHR presentIdFeatures{ .presentId = vk::True };
+    vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{ .presentWait = vk::True };
+    vk::PhysicalDeviceSwapchainMaintenance1FeaturesEXT swapchainMaintenanceFeatures{ .swapchainMaintenance1 = vk::True };
+    vulkan12Features.descriptorIndexing = vk::True;
+    vulkan12Features.runtimeDescriptorArray = vk::True;
+    vulkan12Features.descriptorBindingPartiallyBound = vk::True;
+    vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = vk::True;
+    vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = vk::True;
+    vulkan12Features.descriptorBindingUpdateUnusedWhilePending = vk::True;
+    vulkan12Features.shaderSampledImageArrayNonUniformIndexing = vk::True;
+    vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = supported12.shaderStorageBufferArrayNonUniformIndexing;
+    vulkan12Features.timelineSemaphore = vk::True;
     vulkan13Features.dynamicRendering = vk::True;
     extendedDynamicStateFeatures.extendedDynamicState = vk::True;
     vulkan13Features.synchronization2 = vk::True;
     vulkan13Features.pNext = &extendedDynamicStateFeatures;
-    features.pNext = &vulkan13Features;
+    if (m_presentWait)
+    {
+        presentIdFeatures.pNext = &presentWaitFeatures;
+        extendedDynamicStateFeatures.pNext = &presentIdFeatures;
+    }
+    if (m_presentFences)
+    {
+        swapchainMaintenanceFeatures.pNext = extendedDynamicStateFeatures.pNext;
+        extendedDynamicStateFeatures.pNext = &swapchainMaintenanceFeatures;
+    }
+    vulkan12Features.pNext = &vulkan13Features;
+    features.pNext = &vulkan12Features;
 
     vk::DeviceCreateInfo deviceCreateInfo 
     {
@@ -297,7 +408,7 @@ void Core::setupLogicalDevice()
         .ppEnabledExtensionNames = deviceExtensions.data()
     };
 
-    m_device = vk::raii::Device(m_dGPU, deviceCreateInfo);
+    m_device = vk::raii::Device(m_dGPU, deviceCreateInfo, Allocator::GetHostCallbacks());
     m_queues[QType::Graphics] = vk::raii::Queue(m_device, m_familyIndices[QType::Graphics], 0);
     m_queues[QType::Compute] = vk::raii::Queue(m_device, m_familyIndices[QType::Compute], queueIndices[QType::Compute - 1]);
     m_queues[QType::Transfer] = vk::raii::Queue(m_device, m_familyIndices[QType::Transfer], queueIndices[QType::Transfer - 1]);
@@ -306,18 +417,97 @@ void Core::setupLogicalDevice()
     VULKAN_HPP_DEFAULT_DISPATCHER.init(*m_device);
 }
 
-bool Core::suitableDiscreteGPU(const vk::raii::PhysicalDevice& device)
+int64_t Core::scorePhysicalDevice(const vk::raii::PhysicalDevice& device, std::string& rejection)
 {
-    auto deviceProperties = device.getProperties();
-    auto deviceFeatures = device.getFeatures();
-    if (deviceProperties.deviceType == vk::PhysicalDeviceType::eDiscreteGpu &&
-        deviceFeatures.geometryShader) {
-        if constexpr (DISPLAY_VULKAN_INFO)
-            std::cout << "Selected: " << deviceProperties.deviceName << std::endl;
-        m_dGPU = device;
-        return true;
+    vk::PhysicalDeviceProperties properties = device.getProperties();
+    if (properties.apiVersion < vk::ApiVersion13)
+    {
+        rejection = "Vulkan 1.3 unsupported";
+        return -1;
+    }
+
+    auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features>();
+    const vk::PhysicalDeviceVulkan12Features& features12 = features.get<vk::PhysicalDeviceVulkan12Features>();
+    const vk::PhysicalDeviceVulkan13Features& features13 = features.get<vk::PhysicalDeviceVulkan13Features>();
+    if (!features13.dynamicRendering)
+        rejection = "no dynamic rendering";
+    else if (!features13.synchronization2)
+        rejection = "no synchronization2";
+    else if (!features12.timelineSemaphore)
+        rejection = "no timeline semaphores";
+    else if (!features12.descriptorIndexing || !features12.runtimeDescriptorArray || !features12.descriptorBindingPartiallyBound ||
+        !features12.descriptorBindingSampledImageUpdateAfterBind || !features12.descriptorBindingStorageBufferUpdateAfterBind ||
+        !features12.descriptorBindingUpdateUnusedWhilePending || !features12.shaderSampledImageArrayNonUniformIndexing)
+        rejection = "incomplete descriptor indexing (bindless)";
+    if (!rejection.empty())
+        return -1;
+
+    if (!m_config.headless)
+    {
+        auto extensions = device.enumerateDeviceExtensionProperties();
+        bool swapchain = std::ranges::any_of(extensions,
+            [](const vk::ExtensionProperties& extension) { return strcmp(extension.extensionName, vk::KHRSwapchainExtensionName) == 0; });
+        if (!swapchain)
+        {
+            rejection = "no VK_KHR_swapchain";
+            return -1;
+        }
+    }
+
+    // Queue topology: graphics is required, presenting from the graphics family and
+    // dedicated compute and transfer families are preferred
+    std::vector<vk::QueueFamilyProperties> families = device.getQueueFamilyProperties();
+    bool graphics = false, graphicsPresent = false, present = m_config.headless;
+    bool dedicatedCompute = false, dedicatedTransfer = false;
+    for (uint32_t i = 0; i < families.size(); i++)
+    {
+        vk::QueueFlags flags = families[i].queueFlags;
+        bool familyPresent = !m_config.headless && device.getSurfaceSupportKHR(i, *m_surface);
+        present |= familyPresent;
+        if (flags & vk::QueueFlagBits::eGraphics)
+        {
+            graphics = true;
+            graphicsPresent |= familyPresent;
+        }
+        else if (flags & vk::QueueFlagBits::eCompute)
+            dedicatedCompute = true;
+        else if (flags & vk::QueueFlagBits::eTransfer)
+            dedicatedTransfer = true;
+    }
+    if (!graphics)
+    {
+        rejection = "no graphics queue";
+        return -1;
+    }
+    if (!present)
+    {
+        rejection = "can't present to the window surface";
+        return -1;
+    }
+
+    // Type dominates so a laptop's discrete GPU beats an integrated one sharing a larger system heap,
+    // and software rasterizers (lavapipe) are only picked when nothing else works
+    int64_t score = 0;
+    switch (properties.deviceType)
+    {
+    case vk::PhysicalDeviceType::eDiscreteGpu:      score = 100000; break;
+    case vk::PhysicalDeviceType::eIntegratedGpu:    score = 10000; break;
+    case vk::PhysicalDeviceType::eVirtualGpu:       score = 1000; break;
+    case vk::PhysicalDeviceType::eCpu:              score = 100; break;
+    default:                                        break;
     }
-    return false;
+
+    vk::DeviceSize deviceLocalBytes = 0;
+    vk::PhysicalDeviceMemoryProperties memory = device.getMemoryProperties();
+    for (uint32_t i = 0; i < memory.memoryHeapCount; i++)
+        if (memory.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+            deviceLocalBytes = std::max(deviceLocalBytes, memory.memoryHeaps[i].size);
+    score += static_cast<int64_t>(deviceLocalBytes >> 30) * 10;
+
+    score += graphicsPresent ? 50 : 0;
+    score += dedicatedCompute ? 50 : 0;
+    score += dedicatedTransfer ? 50 : 0;
+    return score;
 }
 
 void Core::createSurface()
@@ -351,16 +541,24 @@ void Core::createSwapChain()
         .preTransform = surfaceCapabilities.currentTransform, 
         .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
         .presentMode = chooseSwapPresentMode(m_dGPU.getSurfacePresentModesKHR(m_surface)),
-        .clipped = true, .oldSwapchain = nullptr
+        .clipped = true, .oldSwapchain = *m_swapChain
     };
 
-    m_swapChain = vk::raii::SwapchainKHR(m_device, swapChainCreateInfo);
+    // Handing off the old swap chain lets the driver reuse its resources and keep presenting
+    // images already queued from it, so it's retired instead of destroyed
+    vk::raii::SwapchainKHR swapChain(m_device, swapChainCreateInfo);
+    if (*m_swapChain)
+        retireSwapChain();
+    m_swapChain = std::move(swapChain);
     m_swapChainImages = m_swapChain.getImages();
     m_swapChainSurfaceFormat = swapChainSurfaceFormat.format;
+    m_swapChainTransform = surfaceCapabilities.currentTransform;
 }
 
 void Core::recreateSwapChain()
 {
+    PROFILE_ZONE("Core::recreateSwapChain");
+    RenderCounters::Add(RenderCounters::Counter::SwapchainRecreations);
     int w, h;
     SDL_GetWindowSize(mp_window->getWindow(), &w, &h);
     
@@ -371,15 +569,110 @@ void Core::recreateSwapChain()
         SDL_WaitEvent(&e);
     }
 
-    m_device.waitIdle();
+    // Only frames in flight record into the old views, so they follow the frame timeline
+    m_deletionQueue.retireObject(std::move(m_swapChainImageViews));
+    m_framePacer.onSwapChainRecreated();
 
-    cleanSwapChain();
     createSwapChain();
     createImageViews();
+    createSyncObjects();
+}
+
+bool Core::swapChainOutdated()
+{
+    auto surfaceCapabilities = m_dGPU.getSurfaceCapabilitiesKHR(m_surface);
+    return chooseSwapExtent(surfaceCapabilities) != m_swapChainExtent
+        || surfaceCapabilities.currentTransform != m_swapChainTransform;
+}
+
+void Core::retireSwapChain()
+{
+    // Presents wait on the render finished semaphores but signal no frame value, so the old swap
+    // chain and its semaphores can't simply be retired with the current frame
+    if (m_presentFences)
+    {
+        m_retiredSwapChains.push_back(RetiredSwapChain{
+            .fences = std::move(m_pendingPresentFences),
+            .swapChain = std::move(m_swapChain),
+            .presentComplete = std::move(m_presentCompleteSemaphores),
+            .renderFinished = std::move(m_renderFinishedSemaphores)
+        });
+        m_pendingPresentFences.clear();
+        return;
+    }
+
+    // Without present fences, once enough frames after the last present to cycle through every
+    // image (and every frame slot) have completed, the old presents have released them
+    uint64_t retireFrame = m_lastPresentFrame + std::max<uint64_t>(m_swapChainImages.size(), m_config.framesInFlight);
+    auto retired = std::make_shared<RetiredSwapChain>(RetiredSwapChain{
+        .swapChain = std::move(m_swapChain),
+        .presentComplete = std::move(m_presentCompleteSemaphores),
+        .renderFinished = std::move(m_renderFinishedSemaphores)
+    });
+    m_swapChain = nullptr;
+    m_presentCompleteSemaphores.clear();
+    m_renderFinishedSemaphores.clear();
+    m_deletionQueue.retireAt(retireFrame, [retired]() {
+        retired->swapChain.clear();
+        retired->presentComplete.clear();
+        retired->renderFinished.clear();
+    });
+}
+
+vk::Fence Core::acquirePresentFence()
+{
+    if (m_freePresentFences.empty())
+        m_pendingPresentFences.emplace_back(m_device, vk::FenceCreateInfo{});
+    else
+    {
+        m_device.resetFences(*m_freePresentFences.back());
+        m_pendingPresentFences.push_back(std::move(m_freePresentFences.back()));
+        m_freePresentFences.pop_back();
+    }
+    return *m_pendingPresentFences.back();
+}
+
+void Core::collectPresentFences()
+{
+    auto signaled = [](const vk::raii::Fence& fence) { return fence.getStatus() == vk::Result::eSuccess; };
+    auto recycle = [this](vk::raii::Fence& fence) { m_freePresentFences.push_back(std::move(fence)); };
+
+    for (size_t i = 0; i < m_pendingPresentFences.size();)
+    {
+        if (!signaled(m_pendingPresentFences[i]))
+        {
+            i++;
+            continue;
+        }
+        recycle(m_pendingPresentFences[i]);
+        m_pendingPresentFences.erase(m_pendingPresentFences.begin() + i);
+    }
+
+    for (size_t i = 0; i < m_retiredSwapChains.size();)
+    {
+        RetiredSwapChain& retired = m_retiredSwapChains[i];
+        if (!std::ranges::all_of(retired.fences, signaled))
+        {
+            i++;
+            continue;
+        }
+        std::ranges::for_each(retired.fences, recycle);
+        m_retiredSwapChains.erase(m_retiredSwapChains.begin() + i);
+    }
 }
 
 void Core::cleanSwapChain()
 {
+    // The device is idle, but presents only finish with their fences
+    for (RetiredSwapChain& retired : m_retiredSwapChains)
+        for (vk::raii::Fence& fence : retired.fences)
+            while (vk::Result::eTimeout == m_device.waitForFences(*fence, vk::True, UINT64_MAX));
+    for (vk::raii::Fence& fence : m_pendingPresentFences)
+        while (vk::Result::eTimeout == m_device.waitForFences(*fence, vk::True, UINT64_MAX));
+
+    m_retiredSwapChains.clear();
+    m_pendingPresentFences.clear();
+    m_freePresentFences.clear();
     m_swapChainImageViews.clear();
     m_swapChain = nullptr;
 }
@@ -411,17 +704,59 @@ void Core::createImageViews()
     }
 }
 
+void Core::createOffscreenTargets()
+{
+    m_swapChainExtent = vk::Extent2D{ m_config.width, m_config.height };
+    m_swapChainSurfaceFormat = vk::Format::eR8G8B8A8Unorm;
+    m_swapChainImages.clear();
+    m_offscreenAllocations.clear();
+
+    // One target per frame in flight, indexed by m_frameIndex in place of a swap chain image index
+    for (size_t i = 0; i < m_config.framesInFlight; i++)
+    {
+        VkImage image = VK_NULL_HANDLE;
+        m_offscreenAllocations.push_back(ImageBuffer::Create(
+            m_device,
+            image,
+            static_cast<VkExtent2D>(m_swapChainExtent),
+            static_cast<VkFormat>(m_swapChainSurfaceFormat),
+            VkImageUsageFlagBits::VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+            VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            0,
+            VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE));
+        m_swapChainImages.emplace_back(image);
+    }
+
+    createImageViews();
+}
+
+void Core::cleanOffscreenTargets()
+{
+    m_swapChainImageViews.clear();
+
+    for (size_t i = 0; i < m_offscreenAllocations.size(); i++)
+        vmaDestroyImage(Allocator::GetAllocator(), static_cast<VkImage>(m_swapChainImages[i]), m_offscreenAllocations[i]);
+
+    m_offscreenAllocations.clear();
+    m_swapChainImages.clear();
+}
+
 void Core::createDescriptorLayout() 
 {
-    vk::DescriptorSetLayoutBinding uboLayoutBinding(0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex, nullptr);
-    vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = 1, .pBindings = &uboLayoutBinding };
-    m_descriptorSetLayout = vk::raii::DescriptorSetLayout(m_device, layoutInfo);
+    vk::DescriptorSetLayoutBinding uboLayoutBinding(0, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex, nullptr);
+    m_descriptorSetLayout = m_descriptorAllocator.getLayout({ &uboLayoutBinding, 1 });
+
+    m_bindless.init(m_device, m_dGPU);
 }
 
 void Core::createGraphicsPipeline()
 {   
-    vk::raii::ShaderModule vertModule = createShaderModule(ReadFile("..\\..\\..\\out\\shaders\\triangle.vert.spv")),
-                           fragModule = createShaderModule(ReadFile("..\\..\\..\\out\\shaders\\triangle.frag.spv"));
+    vk::raii::ShaderModule vertModule = createShaderModule(ReadFile(std::string(THEWHEEL_SHADER_DIR) + "/triangle.vert.spv")),
+                           fragModule = createShaderModule(ReadFile(std::string(THEWHEEL_SHADER_DIR) + "/triangle.frag.spv")),
+                           instancedVertModule = createShaderModule(ReadFile(std::string(THEWHEEL_SHADER_DIR) + "/instanced.vert.spv")),
+                           instancedFragModule = createShaderModule(ReadFile(std::string(THEWHEEL_SHADER_DIR) + "/instanced.frag.spv")),
+                           sceneVertModule = createShaderModule(ReadFile(std::string(THEWHEEL_SHADER_DIR) + "/scene.vert.spv")),
+                           sceneFragModule = createShaderModule(ReadFile(std::string(THEWHEEL_SHADER_DIR) + "/scene.frag.spv"));
 
     vk::PipelineShaderStageCreateInfo vertShaderStageInfo{ 
         .stage = vk::ShaderStageFlagBits::eVertex, 
@@ -508,13 +843,14 @@ void Core::createGraphicsPipeline()
     {
         .stageFlags = vk::ShaderStageFlagBits::eVertex,
         .offset = 0,
-        .size = sizeof(glm::mat4),
+        .size = sizeof(DrawConstants),
     };
 
-    // For uniforms
+    // Set 0: per-object uniforms, set 1 (BINDLESS_SET): bindless resources
+    vk::DescriptorSetLayout setLayouts[] = { m_descriptorSetLayout, *m_bindless.getLayout() };
     vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ 
-        .setLayoutCount = 1, 
-        .pSetLayouts = &*m_descriptorSetLayout, 
+        .setLayoutCount = 2, 
+        .pSetLayouts = setLayouts, 
         .pushConstantRangeCount = 1,
         .pPushConstantRanges = &pcRange
     };
@@ -540,6 +876,57 @@ void Core::createGraphicsPipeline()
     //pipelineInfo.basePipelineIndex = -1; // Optional
 
     m_graphicsPipeline = vk::raii::Pipeline(m_device, nullptr, pipelineInfo);
+
+    // Instanced variant: same state and layout, per-instance attributes streamed from binding 1
+    vk::PipelineShaderStageCreateInfo instancedShaderStages[] = {
+        { .stage = vk::ShaderStageFlagBits::eVertex, .module = instancedVertModule, .pName = "vertMain" },
+        { .stage = vk::ShaderStageFlagBits::eFragment, .module = instancedFragModule, .pName = "fragMain" }
+    };
+
+    vk::VertexInputBindingDescription instancedBindings[] = { Vertex::getBindingDesc(), InstanceData::getBindingDesc() };
+    auto instanceAttributes = InstanceData::getAttribDesc();
+    std::array<vk::VertexInputAttributeDescription, 8> instancedAttributes;
+    instancedAttributes[0] = attributeDescriptions.first;
+    instancedAttributes[1] = attributeDescriptions.second;
+    std::copy(instanceAttributes.begin(), instanceAttributes.end(), instancedAttributes.begin() + 2);
+
+    vk::PipelineVertexInputStateCreateInfo instancedVertexInputInfo{
+        .vertexBindingDescriptionCount = 2,
+        .pVertexBindingDescriptions = instancedBindings,
+        .vertexAttributeDescriptionCount = static_cast<uint32_t>(instancedAttributes.size()),
+        .pVertexAttributeDescriptions = instancedAttributes.data()
+    };
+
+    pipelineInfo.pStages = instancedShaderStages;
+    pipelineInfo.pVertexInputState = &instancedVertexInputInfo;
+    m_instancedPipeline = vk::raii::Pipeline(m_device, nullptr, pipelineInfo);
+
+    // GpuScene variant: the only per-instance attribute is the object's scene slot
+    vk::PipelineShaderStageCreateInfo sceneShaderStages[] = {
+        { .stage = vk::ShaderStageFlagBits::eVertex, .module = sceneVertModule, .pName = "vertMain" },
+        { .stage = vk::ShaderStageFlagBits::eFragment, .module = sceneFragModule, .pName = "fragMain" }
+    };
+
+    vk::VertexInputBindingDescription sceneBindings[] = {
+        Vertex::getBindingDesc(),
+        vk::VertexInputBindingDescription(1, sizeof(uint32_t), vk::VertexInputRate::eInstance)
+    };
+    vk::VertexInputAttributeDescription sceneAttributes[] = {
+        attributeDescriptions.first,
+        attributeDescriptions.second,
+        vk::VertexInputAttributeDescription(2, 1, vk::Format::eR32Uint, 0)
+    };
+
+    vk::PipelineVertexInputStateCreateInfo sceneVertexInputInfo{
+        .vertexBindingDescriptionCount = 2,
+        .pVertexBindingDescriptions = sceneBindings,
+        .vertexAttributeDescriptionCount = 3,
+        .pVertexAttributeDescriptions = sceneAttributes
+    };
+
+    pipelineInfo.pStages = sceneShaderStages;
+    pipelineInfo.pVertexInputState = &sceneVertexInputInfo;
+    m_scenePipeline = vk::raii::Pipeline(m_device, nullptr, pipelineInfo);
 }
 
 void Core::createCommandPools()
@@ -566,7 +953,7 @@ void Core::createCommandBuffers()
     m_commandBuffers[QType::Graphics] = vk::raii::CommandBuffers(m_device, {
         .commandPool = m_commandPools[QType::Graphics],
         .level = vk::CommandBufferLevel::ePrimary,
-        .commandBufferCount = MAX_FRAMES_IN_FLIGHT 
+        .commandBufferCount = m_config.framesInFlight
     });
 
     m_commandBuffers[QType::Transfer].clear();
@@ -581,25 +968,27 @@ void Core::createSyncObjects()
 {
     m_presentCompleteSemaphores.clear();
     m_renderFinishedSemaphores.clear();
-    m_inFlightFences.clear();
 
-    for (size_t i = 0; i < m_swapChainImages.size(); i++)
-    {
+    // An acquire semaphore is reused by the frame in its slot, which starts only after the
+    // previous frame waiting on it completed (there may be more frames in flight than images)
+    for (size_t i = 0; i < m_config.framesInFlight; i++)
         m_presentCompleteSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
-        m_renderFinishedSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
-    }
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-    {
-        m_inFlightFences.emplace_back(m_device, vk::FenceCreateInfo{ .flags = vk::FenceCreateFlagBits::eSignaled });
-    }
+    // Presents of an image wait on its semaphore, so it's reused once the image is acquired again
+    for (size_t i = 0; i < m_swapChainImages.size(); i++)
+        m_renderFinishedSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
 }
 
 void Core::createTextureImages() 
 {
     std::string resource_path = root_dir + "/assets/ktx2/holy_cow.ktx2";
    
+    const uint32_t white = 0xFFFFFFFFu;
+    defaultIB.initBuffer(m_device, 1, 1, &white);
+    m_bindless.registerTexture(defaultIB);
+
     triIB.initBuffer(m_device, resource_path.c_str());
+    m_bindless.registerTexture(triIB);
     
     // ...
     // Vulkan rendering using the texture
@@ -610,6 +999,18 @@ void Core::createTextureImages()
 
 void Core::createTextureSampler() 
 {
+    m_textureSampler = vk::raii::Sampler(m_device, vk::SamplerCreateInfo{
+        .magFilter = vk::Filter::eLinear,
+        .minFilter = vk::Filter::eLinear,
+        .mipmapMode = vk::SamplerMipmapMode::eLinear,
+        .addressModeU = vk::SamplerAddressMode::eRepeat,
+        .addressModeV = vk::SamplerAddressMode::eRepeat,
+        .addressModeW = vk::SamplerAddressMode::eRepeat,
+        .maxLod = vk::LodClampNone
+    });
+
+    // Shaders sample with slot 0
+    m_bindless.registerSampler(*m_textureSampler);
 }
 
 void Core::createMeshes()
@@ -618,35 +1019,44 @@ void Core::createMeshes()
     triangle.init(m_device, &vertex_data, &index_data);
 }
 
+void Core::reserveUniformRing(uint32_t objectCount)
+{
+    vk::DeviceSize alignment = m_dGPU.getProperties().limits.minUniformBufferOffsetAlignment;
+    vk::DeviceSize objectSize = (sizeof(ObjectUniforms) + alignment - 1) & ~(alignment - 1);
+
+    // Room for every stress scene object plus the engine's own objects
+    vk::DeviceSize frameSize = std::max<vk::DeviceSize>(1 << 20, (static_cast<vk::DeviceSize>(objectCount) + 64) * objectSize);
+    if (frameSize <= m_uniformRing.getFrameSize())
+        return;
+
+    // Only called between runs, after the device went idle
+    m_uniformRing.destroy();
+    m_uniformRing.initBuffer(m_device, frameSize, m_config.framesInFlight, alignment);
+}
+
 void Core::createUBOs() 
 {
-    m_uniformBuffers.clear();
-    m_uniformBufferAllocations.clear();
-    m_uniformBuffersMapped.clear();
-    VmaAllocator& allocator = Allocator::GetAllocator();
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
-        VkBuffer buffer({});
-        m_uniformBufferAllocations.push_back(
-            Buffer::Create(
-                m_device,
-                buffer,
-                bufferSize, 
-                VkBufferUsageFlagBits::VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
-                VMA_ALLOCATION_CREATE_MAPPED_BIT,
-                VMA_MEMORY_USAGE_AUTO_PREFER_HOST));
-        void* data = nullptr;
-        vmaMapMemory(allocator, m_uniformBufferAllocations[i], &data);
-        m_uniformBuffers.emplace_back(vk::Buffer(std::move(buffer)));
-        m_uniformBuffersMapped.emplace_back(data);
-    }
+    // Sweeps grow the ring per step instead of sizing it for the largest count up front
+    reserveUniformRing(m_config.stress.sweep ? STRESS_SWEEP_COUNTS[0] : m_config.stress.objectCount);
+
+    uint32_t maxObjects = m_config.stress.sweep ? STRESS_SWEEP_COUNTS[std::size(STRESS_SWEEP_COUNTS) - 1] : m_config.stress.objectCount;
+    uint32_t sceneCapacity = std::max(1024u, m_config.stress.gpuScene ? maxObjects + 64 : 0u);
+    m_gpuScene.init(m_device, m_bindless, *createShaderModule(ReadFile(std::string(THEWHEEL_SHADER_DIR) + "/scene_scatter.spv")), sceneCapacity);
 }
 
 void Core::recordCommandBuffer(uint32_t imageIndex)
 {
+    PROFILE_ZONE("Core::recordCommandBuffer");
     auto& cmd = m_commandBuffers[QType::Graphics][m_frameIndex];
     cmd.begin({});
+    m_gpuProfiler.beginFrame(cmd, m_frameIndex);
+    m_gpuProfiler.beginScope(cmd, "Frame");
+    {
+        GPU_SCOPE(m_gpuProfiler, cmd, "SceneUpload");
+        m_gpuScene.upload(cmd, m_frameIndex);
+        if (m_stressScene.isActive())
+            m_stressScene.flushUniforms(cmd, m_frameIndex);
+    }
     // Before starting rendering, transition the swapchain image to COLOR_ATTACHMENT_OPTIMAL
     transitionImageLayout(
         imageIndex,
@@ -674,30 +1084,66 @@ void Core::recordCommandBuffer(uint32_t imageIndex)
         .pColorAttachments = &attachmentInfo 
     };
 
+    m_gpuProfiler.beginScope(cmd, "MainPass");
     cmd.beginRendering(renderingInfo);
-    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *m_graphicsPipeline);
     cmd.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(m_swapChainExtent.width), static_cast<float>(m_swapChainExtent.height), 0.0f, 1.0f));
     cmd.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), m_swapChainExtent));
+    cmd.pushConstants<DrawConstants>(m_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, DrawConstants{
+        .viewProj = view_proj_matrix,
+        .sceneBuffer = m_gpuScene.getSceneBufferIndex()
+    });
+    m_bindless.bind(cmd, m_pipelineLayout);
     
     // -----DRAW HERE-----
-    triangle.bind(cmd);
-    //cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, *m_descriptorSets[m_frameIndex], nullptr);
-    cmd.pushConstants<glm::mat4>(m_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, render_matrix);
-    triangle.draw(cmd);
+    vk::DescriptorSet objectSet = allocateObjectSet();
+    m_renderQueue.clear();
+    m_renderQueue.push(RenderPacket{
+        .key = SortKey::Make(0, PType::Standard, 0, triangle.getId()),
+        .mesh = &triangle,
+        .pipeline = PType::Standard,
+        .descriptorSet = objectSet,
+        .dynamicOffset = m_uniformRing.push(ObjectUniforms{ .model = constants.model, .color = glm::vec4(1.0f) })
+    });
+
+    if (m_stressScene.isActive())
+    {
+        if (m_stressScene.getConfig().instanced)
+            m_stressScene.submit(m_drawBatcher);
+        else if (m_stressScene.usesPersistentUniforms())
+            m_stressScene.submit(m_renderQueue, allocateObjectSet(m_stressScene.getUniformBuffer()), view_proj_matrix);
+        else
+            m_stressScene.submit(m_renderQueue, objectSet, m_uniformRing, view_proj_matrix);
+    }
+
+    m_drawBatcher.flush(cmd, m_renderQueue);
+
+    {
+        GPU_SCOPE(m_gpuProfiler, cmd, "RenderQueue");
+        vk::Pipeline pipelines[PTypeCount] = { *m_graphicsPipeline, *m_instancedPipeline, *m_scenePipeline };
+        m_renderQueue.record(cmd, m_pipelineLayout, pipelines);
+    }
+
+    if (m_overlay.isVisible())
+    {
+        GPU_SCOPE(m_gpuProfiler, cmd, OVERLAY_SCOPE);
+        m_overlay.record(cmd);
+    }
     
     cmd.endRendering();
+    m_gpuProfiler.endScope(cmd);
     
-    // After rendering, transition the swapchain image to PRESENT_SRC
+    // After rendering, transition the swapchain image to PRESENT_SRC (or TRANSFER_SRC for readback when headless)
     transitionImageLayout(
         imageIndex,
         vk::ImageLayout::eColorAttachmentOptimal,
-        vk::ImageLayout::ePresentSrcKHR,
+        m_config.headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR,
         vk::AccessFlagBits2::eColorAttachmentWrite,                // srcAccessMask
         {},                                                        // dstAccessMask
         vk::PipelineStageFlagBits2::eColorAttachmentOutput,        // srcStage
         vk::PipelineStageFlagBits2::eBottomOfPipe                  // dstStage
     );
 
+    m_gpuProfiler.endScope(cmd);
     cmd.end();
 }
 
@@ -721,11 +1167,17 @@ vk::SurfaceFormatKHR Core::chooseSwapSurfaceFormat(const std::vector<vk::Surface
     return availableFormats[0];
 }
 
-vk::PresentModeKHR Core::chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) \
+vk::PresentModeKHR Core::chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) 
 {
-    for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == vk::PresentModeKHR::eMailbox) {
-            return availablePresentMode;
+    // FIFO is the only mode every device supports, and the one that follows the display refresh
+    PresentPolicy policy = m_config.present.policy;
+    if (policy == PresentPolicy::Vsync || policy == PresentPolicy::LowLatency)
+        return vk::PresentModeKHR::eFifo;
+
+    // Mailbox renders unthrottled without tearing, immediate tears but still beats waiting on vsync
+    for (vk::PresentModeKHR mode : { vk::PresentModeKHR::eMailbox, vk::PresentModeKHR::eImmediate }) {
+        if (std::ranges::find(availablePresentModes, mode) != availablePresentModes.end()) {
+            return mode;
         }
     }
     return vk::PresentModeKHR::eFifo;
@@ -756,10 +1208,14 @@ Core& Core::GetInstance()
 
 std::vector<const char*> Core::getRequiredExtensions()
 {
-    Uint32 sdlExtensionCount = 0;
-    const char* const* sdlExtensions = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
+    std::vector<const char*> extensions;
 
-    std::vector extensions(sdlExtensions, sdlExtensions + sdlExtensionCount);
+    if (!m_config.headless)
+    {
+        Uint32 sdlExtensionCount = 0;
+        const char* const* sdlExtensions = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
+        extensions.assign(sdlExtensions, sdlExtensions + sdlExtensionCount);
+    }
 
 #ifndef NDEBUG
     extensions.push_back(vk::EXTDebugUtilsExtensionName);
@@ -781,12 +1237,19 @@ std::vector<const char*> Core::getRequiredExtensions()
 void Core::run()
 {
 	init();
-	loop();
+	if (m_config.stress.objectCount > 0)
+		runStressScene();
+	else
+	{
+		loop();
+		writeReports(0);
+	}
 	clean();
 }
 
 void Core::updateUniformBuffers() 
 {
+    PROFILE_ZONE("Core::updateUniformBuffers");
     static auto startTime = std::chrono::high_resolution_clock::now();
 
     auto currentTime = std::chrono::high_resolution_clock::now();
@@ -798,62 +1261,79 @@ void Core::updateUniformBuffers()
     constants.proj = ubo.proj = glm::perspective(glm::radians(45.0f), static_cast<float>(m_swapChainExtent.width) / static_cast<float>(m_swapChainExtent.height), 0.1f, 10.0f);
     constants.proj = ubo.proj[1][1] *= -1;
 
-    render_matrix = ubo.proj * ubo.view * ubo.model;
-
-    memcpy(m_uniformBuffersMapped[m_frameIndex], &ubo, sizeof(ubo));
+    view_proj_matrix = ubo.proj * ubo.view;
 }
 
 void Core::createDescriptorPool() 
 {
-    vk::DescriptorPoolSize poolSize(vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT);
-    vk::DescriptorPoolCreateInfo poolInfo{ 
-        .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, 
-        .maxSets = MAX_FRAMES_IN_FLIGHT, 
-        .poolSizeCount = 1, 
-        .pPoolSizes = &poolSize };
-
-    m_descriptorPool = vk::raii::DescriptorPool(m_device, poolInfo);
+    // Non-bindless descriptors are transient: allocated each frame and released by resetting the frame's pools
+    const DescriptorPoolRatio ratios[] = {
+        { vk::DescriptorType::eUniformBufferDynamic, 1.0f },
+        { vk::DescriptorType::eUniformBuffer, 1.0f },
+        { vk::DescriptorType::eStorageBuffer, 1.0f },
+        { vk::DescriptorType::eCombinedImageSampler, 1.0f }
+    };
+    m_descriptorAllocator.init(m_device, 64, ratios);
 }
 
-void Core::createDiscriptorSets() 
+vk::DescriptorSet Core::allocateObjectSet(VkBuffer buffer) 
 {
-    std::vector<vk::DescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, *m_descriptorSetLayout);
-   
-    vk::DescriptorSetAllocateInfo allocInfo{ 
-        .descriptorPool = m_descriptorPool, 
-        .descriptorSetCount = static_cast<uint32_t>(layouts.size()), 
-        .pSetLayouts = layouts.data() };
+    vk::DescriptorSet objectSet = m_descriptorAllocator.allocate(m_descriptorSetLayout);
+
+    // The set views the whole buffer through a dynamic offset, one ObjectUniforms at a time
+    vk::DescriptorBufferInfo bufferInfo{ 
+        .buffer = buffer != VK_NULL_HANDLE ? buffer : m_uniformRing.getBuffer(), 
+        .offset = 0, 
+        .range = sizeof(ObjectUniforms) };
+
+    vk::WriteDescriptorSet descriptorWrite{ 
+        .dstSet = objectSet, 
+        .dstBinding = 0, 
+        .dstArrayElement = 0, 
+        .descriptorCount = 1, 
+        .descriptorType = vk::DescriptorType::eUniformBufferDynamic, 
+        .pBufferInfo = &bufferInfo };
+
+    m_device.updateDescriptorSets(descriptorWrite, {});
+    return objectSet;
+}
 
-    m_descriptorSets.clear();
-    m_descriptorSets = m_device.allocateDescriptorSets(allocInfo);
+void Core::submitAsyncCompute()
+{
+    if (m_particles.getCount() == 0)
+        return;
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) 
-    {
-        vk::DescriptorBufferInfo bufferInfo{ 
-            .buffer = m_uniformBuffers[i], 
-            .offset = 0, 
-            .range = sizeof(UniformBufferObject) };
-
-        vk::WriteDescriptorSet descriptorWrite{ 
-            .dstSet = m_descriptorSets[i], 
-            .dstBinding = 0, 
-            .dstArrayElement = 0, 
-            .descriptorCount = 1, 
-            .descriptorType = vk::DescriptorType::eUniformBuffer, 
-            .pBufferInfo = &bufferInfo };
-
-        m_device.updateDescriptorSets(descriptorWrite, {});
-    }
+    // Graphics never reads the particles, so neither queue waits on the other and the dispatches
+    // overlap rendering freely
+    m_asyncCompute.begin();
+    m_particles.record(m_asyncCompute, 1.0f / 60.0f);
+    m_asyncCompute.submit();
 }
 
 void Core::draw()
 {
-    while (vk::Result::eTimeout == m_device.waitForFences(*m_inFlightFences[m_frameIndex], vk::True, UINT64_MAX));
-
-    auto [result, imageIndex] = m_swapChain.acquireNextImage(UINT64_MAX, *m_presentCompleteSemaphores[m_semaphoreIndex], nullptr);
+    PROFILE_ZONE("Core::draw");
+    {
+        uint64_t waitBegin = Profiler::Now();
+        m_frameIndex = m_frameScheduler.beginFrame();
+        RenderCounters::Add(RenderCounters::Counter::FenceWaitUs, (Profiler::Now() - waitBegin) / 1000);
+    }
+    m_deletionQueue.collect(m_frameScheduler.getCompletedValue());
+    m_deletionQueue.setCurrentValue(m_frameScheduler.getFrameNumber());
+    m_frameAllocator.beginFrame(m_frameIndex);
+    m_uniformRing.beginFrame(m_frameIndex);
+    m_drawBatcher.beginFrame(m_frameIndex, m_frameAllocator.get());
+    m_descriptorAllocator.beginFrame(m_frameIndex);
+    m_defragmenter.update();
+    if (m_presentFences)
+        collectPresentFences();
+
+    auto [result, imageIndex] = m_swapChain.acquireNextImage(UINT64_MAX, *m_presentCompleteSemaphores[m_frameIndex], nullptr);
 
     if (result == vk::Result::eErrorOutOfDateKHR)
     {
+        // Nothing was submitted, so the frame's number must not be waited on
+        m_frameScheduler.cancelFrame();
         recreateSwapChain();
         return;
     }
@@ -862,27 +1342,59 @@ void Core::draw()
         throw std::runtime_error("failed to acquire swap chain image!");
     }
 
-    m_device.resetFences(*m_inFlightFences[m_frameIndex]);
+    submitAsyncCompute();
     m_commandBuffers[QType::Graphics][m_frameIndex].reset();
-    recordCommandBuffer(imageIndex);
+
+    // Fixed step keeps stress runs comparable across machines
+    if (m_stressScene.isActive())
+        m_stressScene.update(1.0f / 60.0f);
 
     updateUniformBuffers();
+    m_overlay.beginFrame(OverlayFrameStats{
+        .cpuFrameMs = m_lastFrameMs,
+        .gpuFrameMs = m_gpuProfiler.getFrameTimeMs(),
+        .passes = m_gpuProfiler.getPassTimings(),
+        .draws = m_renderQueue.getStats().draws,
+        .triangles = m_renderQueue.getStats().triangles,
+        .uploadBytes = m_gpuScene.getUploadedBytes(),
+        .latencyMs = m_framePacer.getLastLatencyMs()
+    });
+    recordCommandBuffer(imageIndex);
+    m_uniformRing.flush();
 
-    vk::PipelineStageFlags waitDestinationStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput);
-    const vk::SubmitInfo   submitInfo{ 
-        .waitSemaphoreCount = 1, 
-        .pWaitSemaphores = &*m_presentCompleteSemaphores[m_semaphoreIndex],
-        .pWaitDstStageMask = &waitDestinationStageMask, 
-        .commandBufferCount = 1, 
-        .pCommandBuffers = &*m_commandBuffers[QType::Graphics][m_frameIndex],
-        .signalSemaphoreCount = 1, 
-        .pSignalSemaphores = &*m_renderFinishedSemaphores[imageIndex],
+    const vk::SemaphoreSubmitInfo waitInfo{
+        .semaphore = *m_presentCompleteSemaphores[m_frameIndex],
+        .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput
     };
-    m_queues[QType::Graphics].submit(submitInfo, *m_inFlightFences[m_frameIndex]);
+    const vk::SemaphoreSubmitInfo signalInfos[] = {
+        {
+            .semaphore = *m_renderFinishedSemaphores[imageIndex],
+            .stageMask = vk::PipelineStageFlagBits2::eAllCommands
+        },
+        m_frameScheduler.getSignalInfo()
+    };
+    const vk::CommandBufferSubmitInfo commandBufferInfo{ .commandBuffer = *m_commandBuffers[QType::Graphics][m_frameIndex] };
+    const vk::SubmitInfo2 submitInfo{
+        .waitSemaphoreInfoCount = 1,
+        .pWaitSemaphoreInfos = &waitInfo,
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &commandBufferInfo,
+        .signalSemaphoreInfoCount = 2,
+        .pSignalSemaphoreInfos = signalInfos
+    };
+    m_queues[QType::Graphics].submit2(submitInfo);
 
     try
     {
+        uint64_t presentId = m_frameScheduler.getFrameNumber();
+        const vk::PresentIdKHR presentIdInfo{ .swapchainCount = 1, .pPresentIds = &presentId };
+        const void* presentNext = m_framePacer.usesPresentWait() ? &presentIdInfo : nullptr;
+        vk::Fence presentFence = m_presentFences ? acquirePresentFence() : nullptr;
+        const vk::SwapchainPresentFenceInfoEXT presentFenceInfo{ .pNext = presentNext, .swapchainCount = 1, .pFences = &presentFence };
+        if (m_presentFences)
+            presentNext = &presentFenceInfo;
         const vk::PresentInfoKHR presentInfoKHR{ 
+            .pNext = presentNext,
             .waitSemaphoreCount = 1, 
             .pWaitSemaphores = &*m_renderFinishedSemaphores[imageIndex],
             .swapchainCount = 1, 
@@ -890,13 +1402,18 @@ void Core::draw()
             .pImageIndices = &imageIndex 
         };
 
+        m_lastPresentFrame = presentId;
         result = m_queues[QType::Present].presentKHR(presentInfoKHR);
-        if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || m_framebufferResized)
+        m_framePacer.onPresent(presentId);
+        // Suboptimal only recreates when the surface actually changed, otherwise compositors that
+        // keep reporting it would have us rebuild the swap chain every frame
+        if (result == vk::Result::eErrorOutOfDateKHR || m_framebufferResized
+            || (result == vk::Result::eSuboptimalKHR && swapChainOutdated()))
         {
             m_framebufferResized = false;
             recreateSwapChain();
         }
-        else if (result != vk::Result::eSuccess)
+        else if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
         {
             throw std::runtime_error("failed to present swap chain image!");
         }
@@ -913,15 +1430,60 @@ void Core::draw()
             throw;
         }
     }
-    
-    m_semaphoreIndex = (m_semaphoreIndex + 1) % m_presentCompleteSemaphores.size();
-    m_frameIndex = (m_frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+}
+
+void Core::drawOffscreen()
+{
+    PROFILE_ZONE("Core::drawOffscreen");
+    {
+        uint64_t waitBegin = Profiler::Now();
+        m_frameIndex = m_frameScheduler.beginFrame();
+        RenderCounters::Add(RenderCounters::Counter::FenceWaitUs, (Profiler::Now() - waitBegin) / 1000);
+    }
+    m_deletionQueue.collect(m_frameScheduler.getCompletedValue());
+    m_deletionQueue.setCurrentValue(m_frameScheduler.getFrameNumber());
+    m_frameAllocator.beginFrame(m_frameIndex);
+    m_uniformRing.beginFrame(m_frameIndex);
+    m_drawBatcher.beginFrame(m_frameIndex, m_frameAllocator.get());
+    m_descriptorAllocator.beginFrame(m_frameIndex);
+    m_defragmenter.update();
+
+    submitAsyncCompute();
+    m_commandBuffers[QType::Graphics][m_frameIndex].reset();
+
+    if (m_stressScene.isActive())
+        m_stressScene.update(1.0f / 60.0f);
+
+    updateUniformBuffers();
+    recordCommandBuffer(m_frameIndex);
+    m_uniformRing.flush();
+
+    const vk::SemaphoreSubmitInfo signalInfo = m_frameScheduler.getSignalInfo();
+    const vk::CommandBufferSubmitInfo commandBufferInfo{ .commandBuffer = *m_commandBuffers[QType::Graphics][m_frameIndex] };
+    const vk::SubmitInfo2 submitInfo{
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &commandBufferInfo,
+        .signalSemaphoreInfoCount = 1,
+        .pSignalSemaphoreInfos = &signalInfo
+    };
+    m_queues[QType::Graphics].submit2(submitInfo);
 }
 
 void Core::init()
 {
-    mp_window = new SDLWindow();
-    mp_window->init();
+    Profiler::SetThreadName("Main");
+    m_tracePath = m_config.tracePath;
+    if (m_tracePath.empty())
+        if (const char* tracePath = std::getenv("THEWHEEL_TRACE"))
+            m_tracePath = tracePath;
+    if (!m_tracePath.empty())
+        Profiler::StartCapture();
+
+    if (!m_config.headless)
+    {
+        mp_window = new SDLWindow();
+        mp_window->init();
+    }
 
     vk::ApplicationInfo appInfo {
         .sType = vk::StructureType::eApplicationInfo,
@@ -962,6 +1524,19 @@ void Core::init()
             }
         }
 
+        // Prerequisites of VK_EXT_swapchain_maintenance1 (present fences)
+        auto hasInstanceExtension = [&extensionProperties](const char* name) {
+            return std::ranges::any_of(extensionProperties,
+                [name](const vk::ExtensionProperties& extension) { return strcmp(extension.extensionName, name) == 0; });
+        };
+        m_surfaceMaintenance = !m_config.headless && hasInstanceExtension(vk::EXTSurfaceMaintenance1ExtensionName)
+            && hasInstanceExtension(vk::KHRGetSurfaceCapabilities2ExtensionName);
+        if (m_surfaceMaintenance)
+        {
+            requiredExtensions.push_back(vk::KHRGetSurfaceCapabilities2ExtensionName);
+            requiredExtensions.push_back(vk::EXTSurfaceMaintenance1ExtensionName);
+        }
+
         if constexpr (DISPLAY_VULKAN_INFO) 
         {
             std::cout << "-----Layers---------\n";
@@ -983,65 +1558,256 @@ void Core::init()
             .ppEnabledExtensionNames = requiredExtensions.data()
         };
 
-        m_instance = vk::raii::Instance{ m_context, createInfo };
+        m_instance = vk::raii::Instance{ m_context, createInfo, Allocator::GetHostCallbacks() };
         VULKAN_HPP_DEFAULT_DISPATCHER.init(*m_instance);
 
 #ifndef NDEBUG
         setupDebugMessenger();
 #endif
-        createSurface();
+        if (!m_config.headless)
+            createSurface();
         selectPhysicalDevices();
         setupLogicalDevice();
-        createSwapChain();
-        createImageViews();
+        // Validates framesInFlight before anything is sized by it
+        m_frameScheduler.init(m_device, m_config.framesInFlight);
+        m_framePacer.init(m_config.present, m_presentWait);
+        Allocator::Init(m_instance, m_dGPU, m_device, m_config.memory, m_memoryBudget);
+        if (m_config.headless)
+            createOffscreenTargets();
+        else
+        {
+            createSwapChain();
+            createImageViews();
+        }
+        createDescriptorPool();
         createDescriptorLayout();
         createGraphicsPipeline();
         createCommandPools();
-        Allocator::Init(m_instance, m_dGPU, m_device);
+#ifndef NDEBUG
+        m_gpuProfiler.init(m_device, m_dGPU, m_familyIndices[QType::Graphics], true);
+#else
+        m_gpuProfiler.init(m_device, m_dGPU, m_familyIndices[QType::Graphics], false);
+#endif
+        createTextureSampler();
         createTextureImages();
         createMeshes();
         createUBOs();
-        createDescriptorPool();
-        createDiscriptorSets();
+        m_drawBatcher.init(m_device);
+        m_defragmenter.init(m_device, m_bindless, m_frameScheduler, m_config.defrag);
         createCommandBuffers();
         createSyncObjects();
+        if (m_config.asyncParticles > 0)
+        {
+#ifndef NDEBUG
+            m_asyncCompute.init(m_device, m_dGPU, m_familyIndices[QType::Compute], m_queues[QType::Compute],
+                m_commandPools[QType::Compute], m_bindless, m_frameScheduler, true);
+#else
+            m_asyncCompute.init(m_device, m_dGPU, m_familyIndices[QType::Compute], m_queues[QType::Compute],
+                m_commandPools[QType::Compute], m_bindless, m_frameScheduler, false);
+#endif
+            m_particles.init(m_device, m_bindless, m_asyncCompute,
+                *createShaderModule(ReadFile(std::string(THEWHEEL_SHADER_DIR) + "/particles.spv")), m_config.asyncParticles);
+        }
+        if (!m_config.headless)
+            m_overlay.init(mp_window->getWindow(), m_instance, m_dGPU, m_device, m_familyIndices[QType::Graphics],
+                m_queues[QType::Graphics], m_swapChainSurfaceFormat, static_cast<uint32_t>(m_swapChainImages.size()), m_config.overlay);
     }
     catch (const vk::SystemError& err) {
         std::cerr << "Vulkan error: " << err.what() << std::endl;
         assert(0);
+        throw;
     }
     catch (const std::exception& err) {
         std::cerr << "Error: " << err.what() << std::endl;
         assert(0);
+        throw;
     }
 }
 
 void Core::loop()
 {
-    while (mp_window->isOpen()) 
+    uint32_t frame = 0;
+    m_measuredHeapAllocations = 0;
+    m_measuredUploadBytes = 0;
+    m_frameStats.clear();
+    m_frameStats.reserve(m_config.frameCount);
+    m_framePacer.clearStats();
+    m_computeOverlap.clear();
+    m_computeOverlap.reserve(m_config.frameCount);
+    m_gpuFrameStats.clear();
+    m_gpuFrameStats.reserve(m_config.frameCount);
+    RenderCounters::Clear();
+    RenderCounters::Reserve(m_config.frameCount);
+    // Drops counts from work done between runs (e.g. stress scene setup uploads)
+    RenderCounters::Snapshot(0);
+    auto lastFrameTime = std::chrono::steady_clock::now();
+
+    while ((m_config.headless || mp_window->isOpen()) &&
+        (m_config.frameCount == 0 || frame < m_config.frameCount))
     {
-        mp_window->checkEvents();
-        draw();
+        uint64_t heapAllocations = HeapStats::GetAllocationCount();
+
+        if (m_config.headless)
+            drawOffscreen();
+        else
+        {
+            // A minimized window shows nothing, so the loop sleeps on events instead of rendering
+            if (mp_window->isMinimized())
+            {
+                mp_window->waitEvents(PACER_MINIMIZED_WAIT_MS);
+                lastFrameTime = std::chrono::steady_clock::now();
+                continue;
+            }
+            // Pacing comes before input sampling, so waits add no latency to the input
+            m_framePacer.pace(m_swapChain, mp_window->isFocused());
+            mp_window->checkEvents();
+            m_framePacer.markInput();
+            draw();
+        }
+
+        auto currentTime = std::chrono::steady_clock::now();
+        m_lastFrameMs = std::chrono::duration<double, std::milli>(currentTime - lastFrameTime).count();
+        RenderCounters::FrameCounters counters = RenderCounters::Snapshot(frame);
+        if (frame++ >= m_config.warmupFrames)
+        {
+            // Open-ended runs only keep a history when it will be exported
+            if (m_config.frameCount > 0 || !m_config.countersCsvPath.empty())
+                RenderCounters::Record(counters);
+            m_frameStats.record(m_lastFrameMs);
+            m_measuredHeapAllocations += HeapStats::GetAllocationCount() - heapAllocations;
+            m_measuredUploadBytes += m_gpuScene.getUploadedBytes();
+            // Resolved timings lag by the frames in flight, so early frames have none
+            if (m_gpuProfiler.getFrameTimeMs() > 0.0)
+                m_gpuFrameStats.record(m_gpuProfiler.getFrameTimeMs());
+            if (m_particles.getCount() > 0)
+                m_computeOverlap.record(GpuProfiler::OverlapMs(m_gpuProfiler, m_asyncCompute.getProfiler()));
+        }
+        lastFrameTime = currentTime;
+
+        if (Profiler::IsCapturing())
+            Profiler::Collect();
     }
 
     m_device.waitIdle();
+    m_deletionQueue.collect(m_frameScheduler.getFrameNumber());
+    // Moves must not be in progress when the caller destroys resources
+    m_defragmenter.finish();
+}
+
+void Core::runStressScene()
+{
+    std::vector<uint32_t> objectCounts = { m_config.stress.objectCount };
+    if (m_config.stress.sweep)
+        objectCounts.assign(std::begin(STRESS_SWEEP_COUNTS), std::end(STRESS_SWEEP_COUNTS));
+
+    for (uint32_t objectCount : objectCounts)
+    {
+        if (!m_config.headless && !mp_window->isOpen())
+            break;
+
+        StressSceneConfig sceneConfig = m_config.stress;
+        sceneConfig.objectCount = objectCount;
+        reserveUniformRing(objectCount);
+        m_stressScene.init(m_device, sceneConfig);
+
+        loop();
+
+        FrameTimeSummary cpu = m_frameStats.summarize();
+        StressSceneResult result{
+            .cpu = cpu,
+            .gpuMs = m_gpuFrameStats.getFrameTimes().empty() ? 0.0 : m_gpuFrameStats.summarize().mean,
+            .drawCount = m_renderQueue.getStats().draws,
+            .bindCount = m_renderQueue.getStats().pipelineBinds + m_renderQueue.getStats().meshBinds + m_renderQueue.getStats().descriptorBinds,
+            .uploadBytes = m_measuredUploadBytes / std::max<uint64_t>(1, cpu.count),
+            .gpuMemoryBytes = Allocator::GetTotalUsage()
+        };
+        m_stressScene.writeCsvRow(result);
+        writeReports(m_config.stress.sweep ? objectCount : 0);
+
+        if constexpr (DISPLAY_VULKAN_INFO)
+            std::cout << "Stress scene: " << objectCount << " objects, CPU " << result.cpu.mean
+                << " ms, GPU " << result.gpuMs << " ms, " << result.drawCount << " draws" << std::endl;
+
+        m_stressScene.destroy();
+    }
+}
+
+//@brief Inserts objectCount before the extension (report.json -> report_1000.json) if non-zero
+static std::filesystem::path SuffixedPath(const std::string& path, uint32_t objectCount)
+{
+    std::filesystem::path suffixed = path;
+    if (objectCount > 0)
+        suffixed.replace_filename(suffixed.stem().string() + "_" + std::to_string(objectCount) + suffixed.extension().string());
+    return suffixed;
+}
+
+void Core::writeReports(uint32_t objectCount)
+{
+    if (!m_config.memoryReportPath.empty())
+    {
+        std::filesystem::path path = SuffixedPath(m_config.memoryReportPath, objectCount);
+        if (!Allocator::WriteReportJson(path.string()))
+            std::cerr << "<Core> failed to write memory report " << path << std::endl;
+        else if constexpr (DISPLAY_VULKAN_INFO)
+            std::cout << "Memory report written to " << path << std::endl;
+    }
+
+    if (!m_config.countersCsvPath.empty())
+    {
+        std::filesystem::path path = SuffixedPath(m_config.countersCsvPath, objectCount);
+        if (!RenderCounters::WriteCsv(path.string()))
+            std::cerr << "<Core> failed to write render counters " << path << std::endl;
+        else if constexpr (DISPLAY_VULKAN_INFO)
+            std::cout << "Render counters written to " << path << std::endl;
+    }
 }
 
 void Core::clean()
 {
     VmaAllocator allocator = Allocator::GetAllocator();
-    cleanSwapChain();
-    
-    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) 
+    if constexpr (DISPLAY_VULKAN_INFO)
     {
-        vmaUnmapMemory(allocator, m_uniformBufferAllocations[i]);
-        vmaDestroyBuffer(allocator, static_cast<VkBuffer>(m_uniformBuffers[i]), m_uniformBufferAllocations[i]);
+        m_gpuProfiler.printTimings(std::cout);
+        Allocator::PrintReport(std::cout);
+        m_defragmenter.printStats(std::cout);
+        if (!m_framePacer.getLatencyStats().getFrameTimes().empty())
+            m_framePacer.getLatencyStats().print(std::cout, "Input to Photon Latency");
+        if (m_particles.getCount() > 0)
+        {
+            m_asyncCompute.getProfiler().printTimings(std::cout);
+            m_computeOverlap.print(std::cout, "Async Compute Overlap");
+        }
     }
+    m_overlay.clean();
+    m_gpuProfiler.clean();
+    if (m_config.headless)
+        cleanOffscreenTargets();
+    else
+        cleanSwapChain();
+    
+    m_uniformRing.destroy();
+    m_drawBatcher.destroy();
 
     triangle.destroy();
     triIB.destroy();
+    defaultIB.destroy();
+    m_textureSampler = nullptr;
+    m_gpuScene.clean();
+    m_particles.clean();
+    m_asyncCompute.clean();
+    m_deletionQueue.flush();
+    m_frameScheduler.clean();
+    m_bindless.clean();
+    m_descriptorAllocator.clean();
     Allocator::Clean();
-    mp_window->clean();
+
+    if (Profiler::IsCapturing() && Profiler::StopCapture(m_tracePath, m_config.traceFormat))
+        if constexpr (DISPLAY_VULKAN_INFO)
+            std::cout << "CPU trace written to " << m_tracePath << std::endl;
+
+    if (mp_window)
+        mp_window->clean();
     Renderer::GetInstance().clean();
     delete(mp_window);
+    mp_window = nullptr;
 }
@@ -1,5 +1,7 @@
 #include "core/geometry/buffers.h"
 #include "core/engine.h"
+#include "core/profiling/cpu_profiler.h"
+#include "core/profiling/render_counters.h"
 #include <ktx.h>
 #include <ktxvulkan.h>
 
@@ -7,6 +9,7 @@
 #include <vma/vk_mem_alloc.h>
 
 VmaAllocator allocator = VK_NULL_HANDLE;
+VmaPool pools[MTypeCount] = {};
 uint32_t qFamilyIndices[2] = { 0, 0 };
 
 uint32_t* pQueueFamilyIndices = nullptr;
@@ -14,20 +17,95 @@ uint32_t queueFamilyIndexCount = 0;
 VkSharingMode sharingMode = VkSharingMode::VK_SHARING_MODE_EXCLUSIVE;
 
 
+constexpr const char* POOL_NAMES[MTypeCount] = { "Mesh", "Texture", "Staging", "Uniform" };
+
 VmaAllocator& Allocator::GetAllocator()
 {
 	return allocator;
 }
 
+//@brief Finds the memory type a resource class's buffers would be placed in
+static uint32_t FindBufferMemoryType(VkBufferUsageFlags usage, VmaAllocationCreateFlags allocFlags, VmaMemoryUsage memUsage)
+{
+	VkBufferCreateInfo bufferInfo{
+		.sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+		.size = 0x10000,
+		.usage = usage,
+		.sharingMode = sharingMode,
+		.queueFamilyIndexCount = queueFamilyIndexCount,
+		.pQueueFamilyIndices = pQueueFamilyIndices
+	};
+
+	VmaAllocationCreateInfo allocCreateInfo = {};
+	allocCreateInfo.usage = memUsage;
+	allocCreateInfo.flags = allocFlags;
+
+	uint32_t memTypeIndex = 0;
+	if (vmaFindMemoryTypeIndexForBufferInfo(allocator, &bufferInfo, &allocCreateInfo, &memTypeIndex) != VK_SUCCESS)
+		throw std::runtime_error("<Allocator> no memory type for buffer pool");
+	return memTypeIndex;
+}
+
+//@brief Finds the memory type sampled textures would be placed in
+static uint32_t FindImageMemoryType()
+{
+	VkImageCreateInfo imageInfo{
+		.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+		.imageType = VkImageType::VK_IMAGE_TYPE_2D,
+		.format = VkFormat::VK_FORMAT_R8G8B8A8_SRGB,
+		.extent = { 256, 256, 1 },
+		.mipLevels = 1,
+		.arrayLayers = 1,
+		.samples = VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT,
+		.tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
+		.usage = VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_DST_BIT | VkImageUsageFlagBits::VK_IMAGE_USAGE_SAMPLED_BIT,
+		.sharingMode = sharingMode,
+		.queueFamilyIndexCount = queueFamilyIndexCount,
+		.pQueueFamilyIndices = pQueueFamilyIndices,
+		.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+	};
+
+	VmaAllocationCreateInfo allocCreateInfo = {};
+	allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+	uint32_t memTypeIndex = 0;
+	if (vmaFindMemoryTypeIndexForImageInfo(allocator, &imageInfo, &allocCreateInfo, &memTypeIndex) != VK_SUCCESS)
+		throw std::runtime_error("<Allocator> no memory type for texture pool");
+	return memTypeIndex;
+}
+
+//@param minBlockCount:	blocks kept alive even when empty
+static void CreatePool(MType memType, uint32_t memTypeIndex, vk::DeviceSize blockSize, VmaPoolCreateFlags flags, size_t minBlockCount)
+{
+	VmaPoolCreateInfo poolInfo = {};
+	poolInfo.memoryTypeIndex = memTypeIndex;
+	poolInfo.flags = flags;
+	poolInfo.blockSize = blockSize;
+	poolInfo.minBlockCount = minBlockCount;
+	poolInfo.maxBlockCount = 0;
+
+	if (vmaCreatePool(allocator, &poolInfo, &pools[memType]) != VK_SUCCESS)
+		throw std::runtime_error(std::string("<Allocator> failed to create ") + POOL_NAMES[memType] + " pool");
+	vmaSetPoolName(allocator, pools[memType], POOL_NAMES[memType]);
+}
+
 void Allocator::Init(vk::raii::Instance& instance,
 	vk::raii::PhysicalDevice& physicalDevice,
-	vk::raii::Device& device) 
+	vk::raii::Device& device,
+	const MemoryPoolConfig& poolConfig,
+	bool memoryBudget) 
 {
 	Core& c = Core::GetInstance();
 	VmaAllocatorCreateInfo info{};
 	info.instance = *instance;               // VkInstance
 	info.physicalDevice = *physicalDevice;   // VkPhysicalDevice
 	info.device = *device;                   // VkDevice
+	info.vulkanApiVersion = VK_API_VERSION_1_3;
+	// Exact per-heap budgets instead of VMA's estimate from heap sizes
+	if (memoryBudget)
+		info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+	// Also used for the buffers, images and memory VMA creates
+	info.pAllocationCallbacks = reinterpret_cast<const VkAllocationCallbacks*>(GetHostCallbacks());
 
 	VkResult r = vmaCreateAllocator(&info, &allocator);
 	if (r != VK_SUCCESS) {
@@ -42,10 +120,83 @@ void Allocator::Init(vk::raii::Instance& instance,
 		queueFamilyIndexCount = 2;
 		pQueueFamilyIndices = qFamilyIndices;
 	}
+
+	// Long-lived meshes and textures: TLSF (VMA's default algorithm) keeps fragmentation low under
+	// arbitrary free order. Mesh memory matches Buffer::Upload so ReBAR memory is kept when present.
+	// Blocks are only created on demand, so an idle pool doesn't pin the (possibly 256 MB) BAR heap.
+	CreatePool(MeshMemory, FindBufferMemoryType(
+		VkBufferUsageFlagBits::VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+		VkBufferUsageFlagBits::VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+		VkBufferUsageFlagBits::VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+		Buffer::UPLOAD_USAGE,
+		VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+		VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT,
+		VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE),
+		poolConfig.blockSize[MeshMemory], 0, 0);
+	CreatePool(TextureMemory, FindImageMemoryType(), poolConfig.blockSize[TextureMemory], 0, 0);
+
+	// Staging buffers are freed in creation order, which the linear algorithm reclaims for free.
+	// One block stays alive so per-frame churn does not map and unmap memory.
+	CreatePool(StagingMemory, FindBufferMemoryType(
+		VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+		VMA_MEMORY_USAGE_AUTO),
+		poolConfig.blockSize[StagingMemory], VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT, 1);
+
+	// Long-lived mapped buffers and uniform rings that are freed and reallocated as they grow:
+	// the default algorithm reuses the holes they leave, which a linear block would not
+	CreatePool(UniformMemory, FindBufferMemoryType(
+		VkBufferUsageFlagBits::VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+		VkBufferUsageFlagBits::VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+		VkBufferUsageFlagBits::VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+		VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		VMA_MEMORY_USAGE_AUTO),
+		poolConfig.blockSize[UniformMemory], 0, 1);
+}
+
+VmaPool Allocator::GetPool(MType memType)
+{
+	return memType < MTypeCount ? pools[memType] : VK_NULL_HANDLE;
+}
+
+const char* Allocator::GetPoolName(MType memType)
+{
+	return memType < MTypeCount ? POOL_NAMES[memType] : "Default";
+}
+
+VmaDetailedStatistics Allocator::GetPoolStats(MType memType)
+{
+	VmaDetailedStatistics stats = {};
+	if (VmaPool pool = GetPool(memType))
+		vmaCalculatePoolStatistics(allocator, pool, &stats);
+	return stats;
+}
+
+uint64_t Allocator::GetTotalUsage()
+{
+	const VkPhysicalDeviceMemoryProperties* memProperties = nullptr;
+	vmaGetMemoryProperties(allocator, &memProperties);
+
+	VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+	vmaGetHeapBudgets(allocator, budgets);
+
+	uint64_t usage = 0;
+	for (uint32_t i = 0; i < memProperties->memoryHeapCount; i++)
+		usage += budgets[i].usage;
+	return usage;
 }
 
 void Allocator::Clean() 
 {
+	for (VmaPool& pool : pools)
+	{
+		if (pool) {
+			vmaDestroyPool(allocator, pool);
+			pool = VK_NULL_HANDLE;
+		}
+	}
+
 	if (allocator) {
 		vmaDestroyAllocator(allocator);
 		allocator = VK_NULL_HANDLE;
@@ -70,7 +221,8 @@ VmaAllocation Buffer::Create(
 	vk::DeviceSize size,
 	VkBufferUsageFlags buffUsage,
 	VmaAllocationCreateFlags allocFlags,
-	VmaMemoryUsage memUsage)
+	VmaMemoryUsage memUsage,
+	MType memType)
 {
 	VkBufferCreateInfo bufferInfo{
 		.sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -84,9 +236,160 @@ VmaAllocation Buffer::Create(
 	VmaAllocationCreateInfo allocCreateInfo = {};
 	allocCreateInfo.usage = memUsage;
 	allocCreateInfo.flags = allocFlags;
+	allocCreateInfo.pool = Allocator::GetPool(memType);
 
 	VmaAllocation allocation;
-	vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer, &allocation, nullptr);
+	VkResult result = vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer, &allocation, nullptr);
+	// A full (or oversized for its block) pool falls back to the default pools
+	if (result != VK_SUCCESS && allocCreateInfo.pool)
+	{
+		allocCreateInfo.pool = VK_NULL_HANDLE;
+		result = vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer, &allocation, nullptr);
+	}
+
+	if (result != VK_SUCCESS)
+		throw std::runtime_error("<Buffer::Create> vmaCreateBuffer failed");
+	return allocation;
+}
+
+//@brief Writes regions into a host-visible allocation and flushes them
+static void WriteMapped(VmaAllocation allocation, std::span<const BufferRegion> regions)
+{
+	void* data = nullptr;
+	if (vmaMapMemory(allocator, allocation, &data) != VK_SUCCESS)
+		throw std::runtime_error("<Buffer::Upload> failed to map buffer");
+
+	for (const BufferRegion& region : regions)
+	{
+		memcpy(static_cast<std::byte*>(data) + region.offset, region.data, (size_t)region.size);
+		vmaFlushAllocation(allocator, allocation, region.offset, region.size);
+	}
+	vmaUnmapMemory(allocator, allocation);
+}
+
+void Buffer::enableMoves(vk::DeviceSize size, VkBufferUsageFlags usage)
+{
+	m_size = size;
+	m_usage = usage | UPLOAD_USAGE;
+	vmaSetAllocationUserData(allocator, m_allocation, this);
+}
+
+void Buffer::retire()
+{
+	if (m_buffer == VK_NULL_HANDLE)
+		return;
+
+	// Retired buffers are no longer offered to the Defragmenter, and a move in progress completes first
+	vmaSetAllocationUserData(allocator, m_allocation, nullptr);
+	Core::GetInstance().getDefragmenter().release(m_allocation);
+	Core::GetInstance().getDeletionQueue().retireBuffer(m_buffer, m_allocation);
+	m_buffer = VK_NULL_HANDLE;
+	m_allocation = VK_NULL_HANDLE;
+}
+
+VkBuffer Buffer::createMoved(VmaAllocation dstAllocation) const
+{
+	VkBufferCreateInfo bufferInfo{
+		.sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+		.size = m_size,
+		.usage = m_usage,
+		.sharingMode = sharingMode,
+		.queueFamilyIndexCount = queueFamilyIndexCount,
+		.pQueueFamilyIndices = pQueueFamilyIndices
+	};
+
+	VkBuffer buffer = VK_NULL_HANDLE;
+	if (vmaCreateAliasingBuffer(allocator, dstAllocation, &bufferInfo, &buffer) != VK_SUCCESS)
+		throw std::runtime_error("<Buffer::createMoved> failed to create buffer");
+	return buffer;
+}
+
+VkImage ImageBuffer::createMoved(VmaAllocation dstAllocation) const
+{
+	VkImageCreateInfo imageInfo{
+		.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+		.imageType = VkImageType::VK_IMAGE_TYPE_2D,
+		.format = m_format,
+		.extent = m_extent,
+		.mipLevels = m_mipLevels,
+		.arrayLayers = 1,
+		.samples = VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT,
+		.tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
+		.usage = m_usage,
+		.sharingMode = sharingMode,
+		.queueFamilyIndexCount = queueFamilyIndexCount,
+		.pQueueFamilyIndices = pQueueFamilyIndices,
+		.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+	};
+
+	VkImage image = VK_NULL_HANDLE;
+	if (vmaCreateAliasingImage(allocator, dstAllocation, &imageInfo, &image) != VK_SUCCESS)
+		throw std::runtime_error("<ImageBuffer::createMoved> failed to create image");
+	return image;
+}
+
+bool Buffer::IsHostVisible(VmaAllocation allocation)
+{
+	VkMemoryPropertyFlags memFlags = 0;
+	vmaGetAllocationMemoryProperties(allocator, allocation, &memFlags);
+	return (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+VmaAllocation Buffer::Upload(
+	vk::raii::Device& device,
+	VkBuffer& buffer,
+	vk::DeviceSize size,
+	VkBufferUsageFlags buffUsage,
+	std::span<const BufferRegion> regions)
+{
+	PROFILE_ZONE("Buffer::Upload");
+	// VMA keeps the buffer device-local and picks a host-visible type when one exists (ReBAR/UMA),
+	// otherwise it falls back to plain device-local memory, which needs TRANSFER_DST for staging.
+	// TRANSFER_SRC lets the Defragmenter copy the buffer out when it moves it.
+	VmaAllocation allocation = Buffer::Create(
+		device,
+		buffer,
+		size,
+		buffUsage | UPLOAD_USAGE,
+		VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+		VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT,
+		VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+		MeshMemory);
+
+	for (const BufferRegion& region : regions)
+		RenderCounters::Add(RenderCounters::Counter::UploadBytes, region.size);
+
+	if (IsHostVisible(allocation))
+	{
+		// Fast path: no staging buffer, no transfer submission
+		WriteMapped(allocation, regions);
+		return allocation;
+	}
+
+	VkBuffer stagingBuffer = VK_NULL_HANDLE;
+	VmaAllocation stagingAllocation = Buffer::Create(
+		device,
+		stagingBuffer,
+		size,
+		VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+		VMA_MEMORY_USAGE_AUTO,
+		StagingMemory);
+
+	WriteMapped(stagingAllocation, regions);
+
+	std::vector<vk::BufferCopy> copies;
+	copies.reserve(regions.size());
+	for (const BufferRegion& region : regions)
+		copies.push_back(vk::BufferCopy{ .srcOffset = region.offset, .dstOffset = region.offset, .size = region.size });
+
+	vk::raii::CommandBuffer commandCopyBuffer = CommandBuffer::BeginSingleUse(device, QType::Transfer);
+	commandCopyBuffer.copyBuffer(stagingBuffer, buffer, copies);
+	vk::raii::Fence fence(device, vk::FenceCreateInfo{});
+	CommandBuffer::EndSingleUse(commandCopyBuffer, QType::Transfer, &fence);
+	vk::Result res = device.waitForFences(*fence, VK_TRUE, UINT64_MAX);
+
+	vmaDestroyBuffer(allocator, stagingBuffer, stagingAllocation);
 	return allocation;
 }
 
@@ -97,6 +400,7 @@ void Buffer::Copy(
 	vk::DeviceSize size,
 	vk::DeviceSize dstOffset)
 {
+	PROFILE_ZONE("Buffer::Copy");
 	vk::raii::CommandBuffer commandCopyBuffer = CommandBuffer::BeginSingleUse(device, QType::Transfer);
 	commandCopyBuffer.copyBuffer(srcBuffer, dstBuffer, vk::BufferCopy(0, dstOffset, size));
 	CommandBuffer::EndSingleUse(commandCopyBuffer, QType::Transfer);
@@ -110,6 +414,7 @@ CommandInfo Buffer::CopyAndReturn(
 	vk::DeviceSize size,
 	vk::DeviceSize dstOffset) 
 {
+	PROFILE_ZONE("Buffer::CopyAndReturn");
 	/*vk::raii::CommandBuffer commandCopyBuffer = CommandBuffer::BeginSingleUse(device, QType::Transfer);
 	commandCopyBuffer.copyBuffer(srcBuffer, dstBuffer, vk::BufferCopy(0, dstOffset, size));
 	vk::raii::Fence fence(device, vk::FenceCreateInfo{});
@@ -136,7 +441,8 @@ VmaAllocation ImageBuffer::Create(
 	VkImageTiling tiling,
 	VkImageUsageFlags usageFlags,
 	VmaAllocationCreateFlags allocFlags,
-	VmaMemoryUsage memUsage)
+	VmaMemoryUsage memUsage,
+	MType memType)
 {
 	VkImageCreateInfo imageInfo{
 		.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
@@ -157,9 +463,62 @@ VmaAllocation ImageBuffer::Create(
 	VmaAllocationCreateInfo allocCreateInfo = {};
 	allocCreateInfo.usage = memUsage;
 	allocCreateInfo.flags = allocFlags;
+	allocCreateInfo.pool = Allocator::GetPool(memType);
+
+	VmaAllocation allocation;
+	VkResult result = vmaCreateImage(allocator, &imageInfo, &allocCreateInfo, &image, &allocation, nullptr);
+	if (result != VK_SUCCESS && allocCreateInfo.pool)
+	{
+		allocCreateInfo.pool = VK_NULL_HANDLE;
+		result = vmaCreateImage(allocator, &imageInfo, &allocCreateInfo, &image, &allocation, nullptr);
+	}
+
+	if (result != VK_SUCCESS)
+		throw std::runtime_error("<ImageBuffer::Create> vmaCreateImage failed");
+	return allocation;
+}
+
+VmaAllocation ImageBuffer::Create(
+	vk::raii::Device& device,
+	VkImage& image,
+	VkExtent2D extent,
+	VkFormat format,
+	VkImageUsageFlags usageFlags,
+	VmaAllocationCreateFlags allocFlags,
+	VmaMemoryUsage memUsage,
+	MType memType)
+{
+	VkImageCreateInfo imageInfo{
+		.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+		.imageType = VkImageType::VK_IMAGE_TYPE_2D,
+		.format = format,
+		.extent = { extent.width, extent.height, 1 },
+		.mipLevels = 1,
+		.arrayLayers = 1,
+		.samples = VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT,
+		.tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
+		.usage = usageFlags,
+		.sharingMode = sharingMode,
+		.queueFamilyIndexCount = queueFamilyIndexCount,
+		.pQueueFamilyIndices = pQueueFamilyIndices,
+		.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+	};
+
+	VmaAllocationCreateInfo allocCreateInfo = {};
+	allocCreateInfo.usage = memUsage;
+	allocCreateInfo.flags = allocFlags;
+	allocCreateInfo.pool = Allocator::GetPool(memType);
 
 	VmaAllocation allocation;
-	vmaCreateImage(allocator, &imageInfo, &allocCreateInfo, &image, &allocation, nullptr);
+	VkResult result = vmaCreateImage(allocator, &imageInfo, &allocCreateInfo, &image, &allocation, nullptr);
+	if (result != VK_SUCCESS && allocCreateInfo.pool)
+	{
+		allocCreateInfo.pool = VK_NULL_HANDLE;
+		result = vmaCreateImage(allocator, &imageInfo, &allocCreateInfo, &image, &allocation, nullptr);
+	}
+
+	if (result != VK_SUCCESS)
+		throw std::runtime_error("<ImageBuffer::Create> vmaCreateImage failed");
 	return allocation;
 }
 
@@ -169,10 +528,12 @@ void ImageBuffer::Copy(
 	VkImage& dstImage,
 	vk::BufferImageCopy biCopy)
 {
-	vk::raii::CommandBuffer commandCopyBuffer = CommandBuffer::BeginSingleUse(device, QType::Transfer);
+	PROFILE_ZONE("ImageBuffer::Copy");
+	// Recorded on the graphics queue, which owns the image afterwards for sampling
+	vk::raii::CommandBuffer commandCopyBuffer = CommandBuffer::BeginSingleUse(device, QType::Graphics);
 	
-	TransitionLayout(
-		device, 
+	RecordTransition(
+		commandCopyBuffer, 
 		dstImage, 
 		VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED, 
 		VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
@@ -184,8 +545,14 @@ void ImageBuffer::Copy(
 		biCopy
 	);
 
-	CommandBuffer::EndSingleUse(commandCopyBuffer, QType::Transfer);
-	Core::GetInstance().getQueue(QType::Transfer).waitIdle();
+	RecordTransition(
+		commandCopyBuffer,
+		dstImage,
+		VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	CommandBuffer::EndSingleUse(commandCopyBuffer, QType::Graphics);
+	Core::GetInstance().getQueue(QType::Graphics).waitIdle();
 }
 
 void ImageBuffer::TransitionLayout(
@@ -195,14 +562,49 @@ void ImageBuffer::TransitionLayout(
 	VkImageLayout newLayout) 
 {
 	vk::raii::CommandBuffer commandBuffer = CommandBuffer::BeginSingleUse(device, QType::Graphics);
+	RecordTransition(commandBuffer, image, oldLayout, newLayout);
+	CommandBuffer::EndSingleUse(commandBuffer, QType::Graphics);
+	Core::GetInstance().getQueue(QType::Graphics).waitIdle();
+}
 
-	VkImageMemoryBarrier mb{
-		.oldLayout = oldLayout,
-		.newLayout = newLayout,
+void ImageBuffer::RecordTransition(
+	vk::raii::CommandBuffer& cmd,
+	const VkImage& image,
+	VkImageLayout oldLayout,
+	VkImageLayout newLayout)
+{
+	vk::ImageMemoryBarrier2 barrier{
+		.srcStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+		.srcAccessMask = vk::AccessFlagBits2::eMemoryWrite,
+		.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+		.dstAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+		.oldLayout = static_cast<vk::ImageLayout>(oldLayout),
+		.newLayout = static_cast<vk::ImageLayout>(newLayout),
+		.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+		.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
 		.image = image,
-		.subresourceRange = {  VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+		.subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 }
 	};
 
-	CommandBuffer::EndSingleUse(commandBuffer, QType::Graphics);
-	Core::GetInstance().getQueue(QType::Graphics).waitIdle();
+	// Narrow the common upload transitions; anything else falls back to a full barrier
+	if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+	{
+		barrier.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+		barrier.srcAccessMask = {};
+		barrier.dstStageMask = vk::PipelineStageFlagBits2::eCopy;
+		barrier.dstAccessMask = vk::AccessFlagBits2::eTransferWrite;
+	}
+	else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+	{
+		barrier.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+		barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+		barrier.dstStageMask = vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eComputeShader;
+		barrier.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+	}
+
+	cmd.pipelineBarrier2(vk::DependencyInfo{
+		.imageMemoryBarrierCount = 1,
+		.pImageMemoryBarriers = &barrier
+	});
+	RenderCounters::Add(RenderCounters::Counter::Barriers);
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "core/geometry/buffers.h"
+#include "core/engine.h"
+#include "core/profiling/cpu_profiler.h"
+#include "core/profiling/render_counters.h"
+
+#include <algorithm>
+
+void DynamicBuffer::initBuffer(
+    vk::raii::Device& device,
+    vk::DeviceSize size,
+    VkBufferUsageFlags usage,
+    uint32_t frameCount,
+    vk::DeviceSize alignment)
+{
+    m_size = size;
+    m_frameCount = std::max(1u, frameCount);
+    m_frameIndex = 0;
+    m_stride = (size + alignment - 1) & ~(alignment - 1);
+
+    // Prefers device-local memory the CPU can write; VMA falls back to plain device-local memory
+    // (with TRANSFER_DST usage) when no such memory type is available or it is too small
+    m_allocation = Buffer::Create(
+        device,
+        m_buffer,
+        m_stride * m_frameCount,
+        usage | VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        MeshMemory);
+
+    VkMemoryPropertyFlags memFlags = 0;
+    vmaGetAllocationMemoryProperties(Allocator::GetAllocator(), m_allocation, &memFlags);
+    m_direct = (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+
+    VmaAllocationInfo allocInfo{};
+    if (m_direct)
+    {
+        vmaGetAllocationInfo(Allocator::GetAllocator(), m_allocation, &allocInfo);
+        mp_mapped = static_cast<std::byte*>(allocInfo.pMappedData);
+        m_coherent = (memFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+    }
+    else
+    {
+        // One staging region per copy so a frame's staged ranges are not overwritten in flight
+        m_stagingAllocation = Buffer::Create(
+            device,
+            m_stagingBuffer,
+            m_stride * m_frameCount,
+            VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+            VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+        vmaGetAllocationInfo(Allocator::GetAllocator(), m_stagingAllocation, &allocInfo);
+        mp_staging = static_cast<std::byte*>(allocInfo.pMappedData);
+        vmaGetAllocationMemoryProperties(Allocator::GetAllocator(), m_stagingAllocation, &memFlags);
+        m_coherent = (memFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+    }
+
+    if (!mp_mapped && !mp_staging)
+        throw std::runtime_error("<DynamicBuffer> failed to map buffer");
+
+    // Copies start out zeroed like the shadow
+    m_shadow.assign(size, std::byte{ 0 });
+    m_dirty.clear();
+    m_generation = 0;
+    m_syncedGenerations.assign(m_frameCount, 0);
+    if (size > 0)
+        m_dirty.push_back(DirtyRange{ .offset = 0, .size = size, .generation = ++m_generation });
+}
+
+void DynamicBuffer::beginFrame(uint32_t frameIndex)
+{
+    m_frameIndex = frameIndex % m_frameCount;
+}
+
+void DynamicBuffer::update(vk::DeviceSize offset, std::span<const std::byte> data)
+{
+    if (data.empty())
+        return;
+    if (offset + data.size() > m_size)
+        throw std::runtime_error("<DynamicBuffer> update out of range");
+
+    memcpy(m_shadow.data() + offset, data.data(), data.size());
+    m_dirty.push_back(DirtyRange{ .offset = offset, .size = data.size(), .generation = ++m_generation });
+}
+
+void DynamicBuffer::flush(
+    vk::raii::CommandBuffer& cmd,
+    vk::PipelineStageFlags2 dstStage,
+    vk::AccessFlags2 dstAccess)
+{
+    PROFILE_ZONE("DynamicBuffer::flush");
+    if (m_dirty.empty() || m_syncedGenerations[m_frameIndex] == m_generation)
+        return;
+
+    uint64_t& synced = m_syncedGenerations[m_frameIndex];
+
+    // Merge the ranges this copy hasn't received, overlapping and adjacent ones included, so each
+    // byte is written once
+    std::sort(m_dirty.begin(), m_dirty.end(), [](const DirtyRange& a, const DirtyRange& b) { return a.offset < b.offset; });
+    m_copies.clear();
+    for (const DirtyRange& range : m_dirty)
+    {
+        if (range.generation <= synced)
+            continue;
+        if (!m_copies.empty() && range.offset <= m_copies.back().dstOffset + m_copies.back().size)
+            m_copies.back().size = std::max(m_copies.back().size, range.offset + range.size - m_copies.back().dstOffset);
+        else
+            m_copies.push_back(vk::BufferCopy{ .srcOffset = range.offset, .dstOffset = range.offset, .size = range.size });
+    }
+    synced = m_generation;
+
+    // Ranges stay queued until every copy has received them
+    uint64_t oldest = *std::ranges::min_element(m_syncedGenerations);
+    std::erase_if(m_dirty, [oldest](const DirtyRange& range) { return range.generation <= oldest; });
+    if (m_copies.empty())
+        return;
+
+    vk::DeviceSize frameBase = getOffset();
+    std::byte* dst = m_direct ? mp_mapped : mp_staging;
+    for (vk::BufferCopy& copy : m_copies)
+    {
+        memcpy(dst + frameBase + copy.dstOffset, m_shadow.data() + copy.dstOffset, copy.size);
+        copy.srcOffset += frameBase;
+        copy.dstOffset += frameBase;
+    }
+
+    vk::DeviceSize uploadBytes = 0;
+    for (const vk::BufferCopy& copy : m_copies)
+        uploadBytes += copy.size;
+    RenderCounters::Add(RenderCounters::Counter::UploadBytes, uploadBytes);
+
+    vk::DeviceSize writeBegin = m_copies.front().dstOffset;
+    vk::DeviceSize writeEnd = m_copies.back().dstOffset + m_copies.back().size;
+    if (!m_coherent)
+        vmaFlushAllocation(Allocator::GetAllocator(), m_direct ? m_allocation : m_stagingAllocation, writeBegin, writeEnd - writeBegin);
+
+    // Host writes are made visible by the queue submission
+    if (m_direct)
+        return;
+
+    cmd.copyBuffer(m_stagingBuffer, m_buffer, m_copies);
+
+    vk::BufferMemoryBarrier2 barrier{
+        .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .dstStageMask = dstStage,
+        .dstAccessMask = dstAccess,
+        .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .buffer = m_buffer,
+        .offset = writeBegin,
+        .size = writeEnd - writeBegin
+    };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &barrier });
+    RenderCounters::Add(RenderCounters::Counter::Barriers);
+}
+
+void DynamicBuffer::destroy()
+{
+    Buffer::destroy();
+    if (m_stagingBuffer != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(Allocator::GetAllocator(), m_stagingBuffer, m_stagingAllocation);
+        m_stagingBuffer = VK_NULL_HANDLE;
+        m_stagingAllocation = VK_NULL_HANDLE;
+    }
+    reset();
+}
+
+void DynamicBuffer::retire()
+{
+    Buffer::retire();
+    if (m_stagingBuffer != VK_NULL_HANDLE)
+    {
+        Core::GetInstance().getDeletionQueue().retireBuffer(m_stagingBuffer, m_stagingAllocation);
+        m_stagingBuffer = VK_NULL_HANDLE;
+        m_stagingAllocation = VK_NULL_HANDLE;
+    }
+    reset();
+}
+
+void DynamicBuffer::reset()
+{
+    mp_mapped = nullptr;
+    mp_staging = nullptr;
+    m_shadow.clear();
+    m_dirty.clear();
+    m_syncedGenerations.clear();
+    m_generation = 0;
+    m_copies.clear();
+    m_size = m_stride = 0;
+}
@@ -1,20 +1,33 @@
 #include "core/geometry/buffers.h"
+#include "core/engine.h"
 #include <ktx.h>
 #include <ktxvulkan.h>
+#include "core/profiling/cpu_profiler.h"
+
+// Sampled textures are also copy sources so the Defragmenter can move them
+constexpr VkImageUsageFlags TEXTURE_USAGE =
+    VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+// Format ImageBuffer::Create allocates ktx images with
+constexpr VkFormat KTX_IMAGE_FORMAT = VkFormat::VK_FORMAT_R8G8B8A8_SRGB;
 
 void ImageBuffer::initBuffer(vk::raii::Device& device, const char* ktx2ImagePath) 
 {
+    PROFILE_ZONE("ImageBuffer::initBuffer");
     VmaAllocator& allocator = Allocator::GetAllocator();
     ktxTexture2* kTexture = nullptr;
 
-    assert(ktx_error_code_e::KTX_SUCCESS == 
-        ktxTexture2_CreateFromNamedFile(
-            ktx2ImagePath,
-            KTX_TEXTURE_CREATE_NO_FLAGS,
-            &kTexture));
+    if (ktxTexture2_CreateFromNamedFile(ktx2ImagePath, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &kTexture) != KTX_SUCCESS)
+        throw std::runtime_error("<ImageBuffer> failed to load " + std::string(ktx2ImagePath));
+
+    // Basis payloads (UASTC/ETC1S, vkFormat UNDEFINED) are transcoded to the RGBA8 the image is created with
+    if (ktxTexture2_NeedsTranscoding(kTexture) &&
+        ktxTexture2_TranscodeBasis(kTexture, KTX_TTF_RGBA32, 0) != KTX_SUCCESS)
+    {
+        ktxTexture2_Destroy(kTexture);
+        throw std::runtime_error("<ImageBuffer> failed to transcode " + std::string(ktx2ImagePath));
+    }
 
     ktx_size_t buffSize = ktxTexture_GetDataSize(ktxTexture(kTexture));
-    std::vector<ktx_uint8_t> buff(buffSize);
     
     VkBuffer stagingBuffer({});
     VmaAllocation allocation = Buffer::Create(
@@ -22,17 +35,13 @@ void ImageBuffer::initBuffer(vk::raii::Device& device, const char* ktx2ImagePath
         stagingBuffer,
         static_cast<vk::DeviceSize>(buffSize),
         VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-
-    assert(ktx_error_code_e::KTX_SUCCESS ==
-        ktxTexture2_LoadImageData(
-            kTexture,
-            buff.data(),
-            buffSize));
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+        VMA_MEMORY_USAGE_AUTO,
+        StagingMemory);
 
     void* data = nullptr;
     vmaMapMemory(allocator, allocation, &data);
-    memcpy(data, buff.data(), (size_t)buffSize);
+    memcpy(data, ktxTexture_GetData(ktxTexture(kTexture)), (size_t)buffSize);
     vmaUnmapMemory(allocator, allocation);
 
     m_allocation = ImageBuffer::Create(
@@ -40,10 +49,10 @@ void ImageBuffer::initBuffer(vk::raii::Device& device, const char* ktx2ImagePath
         m_image,
         kTexture,
         VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
-        VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-        VkImageUsageFlagBits::VK_IMAGE_USAGE_SAMPLED_BIT,
+        TEXTURE_USAGE,
         0,
-        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        TextureMemory);
 
     vk::BufferImageCopy region{ 
         .bufferOffset = 0, 
@@ -53,6 +62,7 @@ void ImageBuffer::initBuffer(vk::raii::Device& device, const char* ktx2ImagePath
         .imageOffset = {0, 0, 0}, 
         .imageExtent = {kTexture->baseWidth, kTexture->baseHeight, 1} };
     
+    uint32_t levels = kTexture->numLevels;
     ktxTexture2_Destroy(kTexture);
 
     ImageBuffer::Copy(
@@ -63,10 +73,117 @@ void ImageBuffer::initBuffer(vk::raii::Device& device, const char* ktx2ImagePath
     );
 
     vmaDestroyBuffer(allocator, stagingBuffer, allocation);
+    // The file's vkFormat may be UNDEFINED (Basis), the view must match the image
+    createView(device, KTX_IMAGE_FORMAT);
+    enableMoves({ region.imageExtent.width, region.imageExtent.height, 1 }, KTX_IMAGE_FORMAT, levels, TEXTURE_USAGE);
+}
+
+void ImageBuffer::initBuffer(vk::raii::Device& device, uint32_t width, uint32_t height, const uint32_t* pixels)
+{
+    PROFILE_ZONE("ImageBuffer::initBuffer");
+    VmaAllocator& allocator = Allocator::GetAllocator();
+    vk::DeviceSize buffSize = static_cast<vk::DeviceSize>(width) * height * sizeof(uint32_t);
+
+    VkBuffer stagingBuffer({});
+    VmaAllocation allocation = Buffer::Create(
+        device,
+        stagingBuffer,
+        buffSize,
+        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+        VMA_MEMORY_USAGE_AUTO,
+        StagingMemory);
+
+    void* data = nullptr;
+    vmaMapMemory(allocator, allocation, &data);
+    memcpy(data, pixels, (size_t)buffSize);
+    vmaUnmapMemory(allocator, allocation);
+
+    m_allocation = ImageBuffer::Create(
+        device,
+        m_image,
+        VkExtent2D{ width, height },
+        VkFormat::VK_FORMAT_R8G8B8A8_SRGB,
+        TEXTURE_USAGE,
+        0,
+        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        TextureMemory);
+
+    vk::BufferImageCopy region{ 
+        .bufferOffset = 0, 
+        .bufferRowLength = 0, 
+        .bufferImageHeight = 0,
+        .imageSubresource = { vk::ImageAspectFlagBits::eColor, 0, 0, 1 }, 
+        .imageOffset = {0, 0, 0}, 
+        .imageExtent = {width, height, 1} };
+
+    ImageBuffer::Copy(
+        device,
+        stagingBuffer,
+        m_image,
+        region
+    );
+
+    vmaDestroyBuffer(allocator, stagingBuffer, allocation);
+    createView(device, VkFormat::VK_FORMAT_R8G8B8A8_SRGB);
+    enableMoves({ width, height, 1 }, VkFormat::VK_FORMAT_R8G8B8A8_SRGB, 1, TEXTURE_USAGE);
+}
+
+void ImageBuffer::createView(vk::raii::Device& device, VkFormat format)
+{
+    m_view = vk::raii::ImageView(device, vk::ImageViewCreateInfo{
+        .image = m_image,
+        .viewType = vk::ImageViewType::e2D,
+        .format = static_cast<vk::Format>(format),
+        .subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 }
+    });
+}
+
+void ImageBuffer::enableMoves(VkExtent3D extent, VkFormat format, uint32_t mipLevels, VkImageUsageFlags usage)
+{
+    m_extent = extent;
+    m_format = format;
+    m_mipLevels = mipLevels;
+    m_usage = usage;
+    vmaSetAllocationUserData(Allocator::GetAllocator(), m_allocation, this);
+}
+
+VkImage ImageBuffer::swapImage(vk::raii::Device& device, VkImage image, vk::raii::ImageView& previousView)
+{
+    std::swap(m_image, image);
+    previousView = std::move(m_view);
+    createView(device, m_format);
+    return image;
+}
+
+void ImageBuffer::retire()
+{
+    if (m_image == VK_NULL_HANDLE)
+        return;
+
+    DeletionQueue& deletionQueue = Core::GetInstance().getDeletionQueue();
+    vmaSetAllocationUserData(Allocator::GetAllocator(), m_allocation, nullptr);
+    Core::GetInstance().getDefragmenter().release(m_allocation);
+    deletionQueue.retireImage(m_image, m_allocation, std::move(m_view));
+
+    // Frames in flight may still sample through the slot, so it's only reused afterwards
+    if (m_bindlessIndex != BINDLESS_INVALID_INDEX)
+    {
+        uint32_t slot = m_bindlessIndex;
+        deletionQueue.retire([slot]() { Core::GetInstance().getBindlessRegistry().releaseTexture(slot); });
+    }
+
+    m_view = nullptr;
+    m_bindlessIndex = BINDLESS_INVALID_INDEX;
+    m_image = VK_NULL_HANDLE;
+    m_allocation = VK_NULL_HANDLE;
 }
 
 void ImageBuffer::destroy() 
 {
+    m_view = nullptr;
+    m_bindlessIndex = UINT32_MAX;
+
     if (m_image != VK_NULL_HANDLE) {
         vmaDestroyImage(Allocator::GetAllocator(), m_image, m_allocation);
         m_image = VK_NULL_HANDLE;
@@ -1,36 +1,20 @@
 #include "core/geometry/buffers.h"
+#include "core/profiling/cpu_profiler.h"
 
 void IndexBuffer::initBuffer(
     vk::raii::Device& device, 
     std::vector<uint32_t> const* indices)
 {
-    VmaAllocator& allocator = Allocator::GetAllocator();
+    PROFILE_ZONE("IndexBuffer::initBuffer");
     m_numIndices = indices->size();
     vk::DeviceSize iSize = sizeof((*indices)[0]) * m_numIndices;
-    
-    VkBuffer stagingBuffer({});
-    
-    VmaAllocation allocation = Buffer::Create(
-        device,
-        stagingBuffer,
-        iSize,
-        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-
-    void* data = nullptr;
-    vmaMapMemory(allocator, allocation, &data);
-    memcpy(data, indices->data(), (size_t)iSize);
-    vmaUnmapMemory(allocator, allocation);
+    BufferRegion region{ .data = indices->data(), .size = iSize };
 
-    m_allocation = Buffer::Create(
+    m_allocation = Buffer::Upload(
         device,
         m_buffer,
-        iSize, 
-        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_DST_BIT | 
+        iSize,
         VkBufferUsageFlagBits::VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        0,
-        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
-
-    Buffer::Copy(device, stagingBuffer, m_buffer, iSize);
-    vmaDestroyBuffer(allocator, stagingBuffer, allocation);
-}
\ No newline at end of file
+        { &region, 1 });
+    enableMoves(iSize, VkBufferUsageFlagBits::VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+}
@@ -0,0 +1,43 @@
+#include "core/geometry/buffers.h"
+
+bool MappedBuffer::reserve(vk::raii::Device& device, vk::DeviceSize size, VkBufferUsageFlags usage)
+{
+    if (size <= m_capacity && m_buffer != VK_NULL_HANDLE)
+        return false;
+
+    // Grow geometrically so a slowly rising size does not reallocate every frame
+    vk::DeviceSize capacity = std::max({ size, m_capacity + m_capacity / 2, vk::DeviceSize(16 << 10) });
+
+    destroy();
+    mp_mapped = nullptr;
+
+    m_allocation = Buffer::Create(
+        device,
+        m_buffer,
+        capacity,
+        usage,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        VMA_MEMORY_USAGE_AUTO,
+        UniformMemory);
+
+    VmaAllocationInfo allocInfo{};
+    vmaGetAllocationInfo(Allocator::GetAllocator(), m_allocation, &allocInfo);
+    mp_mapped = static_cast<std::byte*>(allocInfo.pMappedData);
+
+    VkMemoryPropertyFlags memFlags = 0;
+    vmaGetAllocationMemoryProperties(Allocator::GetAllocator(), m_allocation, &memFlags);
+    m_coherent = (memFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+    if (!mp_mapped)
+        throw std::runtime_error("<MappedBuffer> failed to map buffer");
+
+    m_capacity = capacity;
+    return true;
+}
+
+void MappedBuffer::flush(vk::DeviceSize size)
+{
+    if (!m_coherent && size > 0)
+        vmaFlushAllocation(Allocator::GetAllocator(), m_allocation, 0, size);
+}
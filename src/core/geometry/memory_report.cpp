@@ -0,0 +1,257 @@
+#include "core/geometry/buffers.h"
+
+#include <atomic>
+#include <fstream>
+#include <new>
+
+//@brief Stored in front of each host allocation because the free callback receives no size
+struct HostHeader
+{
+	size_t size;
+	size_t alignment;
+};
+
+static std::atomic<uint64_t> hostBytes{ 0 };
+static std::atomic<uint64_t> hostPeakBytes{ 0 };
+static std::atomic<uint64_t> hostLiveAllocations{ 0 };
+static std::atomic<uint64_t> hostTotalAllocations{ 0 };
+static std::atomic<uint64_t> hostInternalBytes{ 0 };
+
+//@brief Header size that keeps the user pointer aligned to alignment
+static size_t HeaderSize(size_t alignment)
+{
+	return alignment > sizeof(HostHeader) ? alignment : sizeof(HostHeader);
+}
+
+static void* VKAPI_PTR HostAllocate(void*, size_t size, size_t alignment, VkSystemAllocationScope)
+{
+	if (size == 0)
+		return nullptr;
+
+	alignment = alignment < alignof(std::max_align_t) ? alignof(std::max_align_t) : alignment;
+	size_t header = HeaderSize(alignment);
+	auto* base = static_cast<std::byte*>(::operator new(header + size, std::align_val_t(alignment), std::nothrow));
+	if (!base)
+		return nullptr;
+
+	std::byte* ptr = base + header;
+	*(reinterpret_cast<HostHeader*>(ptr) - 1) = HostHeader{ .size = size, .alignment = alignment };
+
+	uint64_t bytes = hostBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	uint64_t peak = hostPeakBytes.load(std::memory_order_relaxed);
+	while (bytes > peak && !hostPeakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed));
+	hostLiveAllocations.fetch_add(1, std::memory_order_relaxed);
+	hostTotalAllocations.fetch_add(1, std::memory_order_relaxed);
+	return ptr;
+}
+
+static void VKAPI_PTR HostFree(void*, void* memory)
+{
+	if (!memory)
+		return;
+
+	HostHeader header = *(static_cast<HostHeader*>(memory) - 1);
+	hostBytes.fetch_sub(header.size, std::memory_order_relaxed);
+	hostLiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	::operator delete(static_cast<std::byte*>(memory) - HeaderSize(header.alignment), std::align_val_t(header.alignment));
+}
+
+static void* VKAPI_PTR HostReallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+	if (!original)
+		return HostAllocate(userData, size, alignment, scope);
+	if (size == 0)
+	{
+		HostFree(userData, original);
+		return nullptr;
+	}
+
+	// On failure the original allocation must stay valid
+	void* moved = HostAllocate(userData, size, alignment, scope);
+	if (!moved)
+		return nullptr;
+
+	size_t oldSize = (static_cast<HostHeader*>(original) - 1)->size;
+	memcpy(moved, original, oldSize < size ? oldSize : size);
+	HostFree(userData, original);
+	return moved;
+}
+
+static void VKAPI_PTR HostInternalAllocate(void*, size_t size, VkInternalAllocationType, VkSystemAllocationScope)
+{
+	hostInternalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+static void VKAPI_PTR HostInternalFree(void*, size_t size, VkInternalAllocationType, VkSystemAllocationScope)
+{
+	hostInternalBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+const vk::AllocationCallbacks* Allocator::GetHostCallbacks()
+{
+	static const VkAllocationCallbacks callbacks{
+		.pUserData = nullptr,
+		.pfnAllocation = HostAllocate,
+		.pfnReallocation = HostReallocate,
+		.pfnFree = HostFree,
+		.pfnInternalAllocation = HostInternalAllocate,
+		.pfnInternalFree = HostInternalFree
+	};
+	return reinterpret_cast<const vk::AllocationCallbacks*>(&callbacks);
+}
+
+//@brief Converts VMA statistics of a resource class
+static CategoryUsage MakeCategory(const char* name, const VmaDetailedStatistics& stats)
+{
+	CategoryUsage category{
+		.name = name,
+		.blockCount = stats.statistics.blockCount,
+		.allocationCount = stats.statistics.allocationCount,
+		.blockBytes = stats.statistics.blockBytes,
+		.allocationBytes = stats.statistics.allocationBytes
+	};
+
+	uint64_t freeBytes = category.blockBytes - category.allocationBytes;
+	if (freeBytes > 0 && stats.unusedRangeCount > 0)
+		category.fragmentation = 1.0f - static_cast<float>(static_cast<double>(stats.unusedRangeSizeMax) / freeBytes);
+	return category;
+}
+
+std::vector<HeapUsage> Allocator::GetHeapUsage()
+{
+	std::vector<HeapUsage> heaps;
+	VmaAllocator allocator = GetAllocator();
+
+	const VkPhysicalDeviceMemoryProperties* memProperties = nullptr;
+	vmaGetMemoryProperties(allocator, &memProperties);
+
+	VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+	vmaGetHeapBudgets(allocator, budgets);
+
+	for (uint32_t i = 0; i < memProperties->memoryHeapCount; i++)
+	{
+		heaps.push_back(HeapUsage{
+			.heapIndex = i,
+			.deviceLocal = (memProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+			.budget = budgets[i].budget,
+			.usage = budgets[i].usage,
+			.blockBytes = budgets[i].statistics.blockBytes,
+			.allocationBytes = budgets[i].statistics.allocationBytes
+		});
+	}
+	return heaps;
+}
+
+MemoryReport Allocator::GetReport()
+{
+	MemoryReport report;
+	VmaAllocator allocator = GetAllocator();
+	report.heaps = GetHeapUsage();
+
+	VmaTotalStatistics total = {};
+	vmaCalculateStatistics(allocator, &total);
+
+	// The default pools are whatever the custom pools don't account for
+	CategoryUsage defaults = MakeCategory(GetPoolName(MTypeCount), total.total);
+	for (uint32_t i = 0; i < MTypeCount; i++)
+	{
+		CategoryUsage category = MakeCategory(GetPoolName(static_cast<MType>(i)), GetPoolStats(static_cast<MType>(i)));
+		defaults.blockCount -= category.blockCount;
+		defaults.allocationCount -= category.allocationCount;
+		defaults.blockBytes -= category.blockBytes;
+		defaults.allocationBytes -= category.allocationBytes;
+		report.categories.push_back(category);
+	}
+	// Free ranges of the default pools can't be told apart from the custom pools' ones
+	defaults.fragmentation = 0.0f;
+	report.categories.push_back(defaults);
+
+	report.host = HostUsage{
+		.bytes = hostBytes.load(std::memory_order_relaxed),
+		.peakBytes = hostPeakBytes.load(std::memory_order_relaxed),
+		.liveAllocations = hostLiveAllocations.load(std::memory_order_relaxed),
+		.totalAllocations = hostTotalAllocations.load(std::memory_order_relaxed),
+		.internalBytes = hostInternalBytes.load(std::memory_order_relaxed)
+	};
+	return report;
+}
+
+void Allocator::PrintReport(std::ostream& out)
+{
+	constexpr double MiB = 1024.0 * 1024.0;
+	MemoryReport report = GetReport();
+
+	out << "Memory heaps:\n";
+	for (const HeapUsage& heap : report.heaps)
+	{
+		out << "  Heap " << heap.heapIndex << (heap.deviceLocal ? " (device local): " : ": ")
+			<< heap.usage / MiB << " / " << heap.budget / MiB << " MiB budget, "
+			<< heap.blockBytes / MiB << " MiB in blocks, "
+			<< heap.allocationBytes / MiB << " MiB allocated\n";
+	}
+
+	out << "Memory pools:\n";
+	for (const CategoryUsage& category : report.categories)
+	{
+		out << "  " << category.name << ": "
+			<< category.blockCount << " blocks, "
+			<< category.blockBytes / MiB << " MiB reserved, "
+			<< category.allocationCount << " allocations, "
+			<< category.allocationBytes / MiB << " MiB used, "
+			<< category.fragmentation * 100.0f << "% fragmented\n";
+	}
+
+	out << "Host allocations: " << report.host.bytes / MiB << " MiB in "
+		<< report.host.liveAllocations << " live allocations (peak "
+		<< report.host.peakBytes / MiB << " MiB, " << report.host.totalAllocations << " total), "
+		<< report.host.internalBytes / MiB << " MiB driver internal" << std::endl;
+}
+
+bool Allocator::WriteReportJson(const std::string& path)
+{
+	std::ofstream out(path, std::ios::trunc);
+	if (!out.is_open())
+		return false;
+
+	MemoryReport report = GetReport();
+
+	out << "{\n  \"Heaps\": [";
+	for (size_t i = 0; i < report.heaps.size(); i++)
+	{
+		const HeapUsage& heap = report.heaps[i];
+		out << (i ? ",\n" : "\n")
+			<< "    { \"Index\": " << heap.heapIndex
+			<< ", \"DeviceLocal\": " << (heap.deviceLocal ? "true" : "false")
+			<< ", \"Budget\": " << heap.budget
+			<< ", \"Usage\": " << heap.usage
+			<< ", \"BlockBytes\": " << heap.blockBytes
+			<< ", \"AllocationBytes\": " << heap.allocationBytes << " }";
+	}
+
+	out << "\n  ],\n  \"Categories\": [";
+	for (size_t i = 0; i < report.categories.size(); i++)
+	{
+		const CategoryUsage& category = report.categories[i];
+		out << (i ? ",\n" : "\n")
+			<< "    { \"Name\": \"" << category.name << '"'
+			<< ", \"BlockCount\": " << category.blockCount
+			<< ", \"AllocationCount\": " << category.allocationCount
+			<< ", \"BlockBytes\": " << category.blockBytes
+			<< ", \"AllocationBytes\": " << category.allocationBytes
+			<< ", \"Fragmentation\": " << category.fragmentation << " }";
+	}
+
+	out << "\n  ],\n  \"Host\": { \"Bytes\": " << report.host.bytes
+		<< ", \"PeakBytes\": " << report.host.peakBytes
+		<< ", \"LiveAllocations\": " << report.host.liveAllocations
+		<< ", \"TotalAllocations\": " << report.host.totalAllocations
+		<< ", \"InternalBytes\": " << report.host.internalBytes << " },\n";
+
+	// Detailed map of every block and allocation
+	char* vmaStats = nullptr;
+	vmaBuildStatsString(GetAllocator(), &vmaStats, VK_TRUE);
+	out << "  \"Vma\": " << vmaStats << "\n}\n";
+	vmaFreeStatsString(GetAllocator(), vmaStats);
+
+	return out.good();
+}
@@ -8,4 +8,9 @@ void Mesh::bind(vk::raii::CommandBuffer& cmd)
 void Mesh::draw(vk::raii::CommandBuffer& cmd)
 {
 	cmd.drawIndexed(m_buffer.getIndicesCount(), 1, 0, 0, 0);
+}
+
+void Mesh::draw(vk::raii::CommandBuffer& cmd, uint32_t instanceCount, uint32_t firstInstance)
+{
+	cmd.drawIndexed(m_buffer.getIndicesCount(), instanceCount, 0, 0, firstInstance);
 }
\ No newline at end of file
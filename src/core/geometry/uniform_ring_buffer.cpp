@@ -0,0 +1,62 @@
+#include "core/geometry/buffers.h"
+#include "core/profiling/render_counters.h"
+
+void UniformRingBuffer::initBuffer(
+    vk::raii::Device& device,
+    vk::DeviceSize frameSize,
+    uint32_t frameCount,
+    vk::DeviceSize minAlignment)
+{
+    m_alignment = std::max<vk::DeviceSize>(minAlignment, 16);
+    m_frameSize = (frameSize + m_alignment - 1) & ~(m_alignment - 1);
+    m_frameBase = m_head = 0;
+
+    m_allocation = Buffer::Create(
+        device,
+        m_buffer,
+        m_frameSize * frameCount,
+        VkBufferUsageFlagBits::VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        VMA_MEMORY_USAGE_AUTO,
+        UniformMemory);
+
+    VmaAllocationInfo allocInfo{};
+    vmaGetAllocationInfo(Allocator::GetAllocator(), m_allocation, &allocInfo);
+    mp_mapped = static_cast<std::byte*>(allocInfo.pMappedData);
+
+    VkMemoryPropertyFlags memFlags = 0;
+    vmaGetAllocationMemoryProperties(Allocator::GetAllocator(), m_allocation, &memFlags);
+    m_coherent = (memFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+    if (!mp_mapped)
+        throw std::runtime_error("<UniformRingBuffer> failed to map ring buffer");
+}
+
+void UniformRingBuffer::beginFrame(uint32_t frameIndex)
+{
+    m_frameBase = m_frameSize * frameIndex;
+    m_head = 0;
+}
+
+UniformAllocation UniformRingBuffer::allocate(vk::DeviceSize size)
+{
+    vk::DeviceSize offset = m_head;
+    vk::DeviceSize alignedSize = (size + m_alignment - 1) & ~(m_alignment - 1);
+
+    if (offset + alignedSize > m_frameSize)
+        throw std::runtime_error("<UniformRingBuffer> frame region exhausted");
+
+    m_head += alignedSize;
+    return UniformAllocation{
+        .data = mp_mapped + m_frameBase + offset,
+        .offset = static_cast<uint32_t>(m_frameBase + offset)
+    };
+}
+
+void UniformRingBuffer::flush()
+{
+    RenderCounters::Add(RenderCounters::Counter::UploadBytes, m_head);
+    if (!m_coherent && m_head > 0)
+        vmaFlushAllocation(Allocator::GetAllocator(), m_allocation, m_frameBase, m_head);
+}
@@ -1,34 +1,19 @@
 #include "core/geometry/buffers.h"
+#include "core/profiling/cpu_profiler.h"
 
 void VertexBuffer::initBuffer(
     vk::raii::Device& device, 
     std::vector<Vertex> const* vertices)
 {
-    VmaAllocator& allocator = Allocator::GetAllocator();
+    PROFILE_ZONE("VertexBuffer::initBuffer");
     vk::DeviceSize bufferSize = sizeof((*vertices)[0]) * vertices->size();
-    VkBuffer stagingBuffer({});
+    BufferRegion region{ .data = vertices->data(), .size = bufferSize };
 
-    VmaAllocation allocation = Buffer::Create(
+    m_allocation = Buffer::Upload(
         device,
-        stagingBuffer,
-        bufferSize,
-        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-    
-    void* data = nullptr;
-    vmaMapMemory(allocator, allocation, &data);
-    memcpy(data, vertices->data(), (size_t)bufferSize);
-    vmaUnmapMemory(allocator, allocation);
-        
-    m_allocation = Buffer::Create(
-        device, 
         m_buffer,
-        bufferSize, 
-        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+        bufferSize,
         VkBufferUsageFlagBits::VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        0,
-        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
-
-    Buffer::Copy(device, stagingBuffer, m_buffer, bufferSize);
-    vmaDestroyBuffer(allocator, stagingBuffer, allocation);
+        { &region, 1 });
+    enableMoves(bufferSize, VkBufferUsageFlagBits::VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
 }
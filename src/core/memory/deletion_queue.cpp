@@ -0,0 +1,88 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/memory/deletion_queue.h"
+#include "core/profiling/cpu_profiler.h"
+
+void DeletionQueue::Destroy(Entry& entry)
+{
+    // Views go before the images they reference
+    entry.view = nullptr;
+    // Allocations retired before a defragmentation pass started can still be among its moves
+    if (entry.allocation != VK_NULL_HANDLE)
+        Core::GetInstance().getDefragmenter().release(entry.allocation);
+    if (entry.buffer != VK_NULL_HANDLE)
+        vmaDestroyBuffer(Allocator::GetAllocator(), entry.buffer, entry.allocation);
+    if (entry.image != VK_NULL_HANDLE)
+        vmaDestroyImage(Allocator::GetAllocator(), entry.image, entry.allocation);
+    if (entry.release)
+        entry.release();
+}
+
+void DeletionQueue::push(Entry&& entry)
+{
+    std::lock_guard lock(m_mutex);
+    entry.value = m_currentValue;
+    insert(std::move(entry));
+}
+
+void DeletionQueue::insert(Entry&& entry)
+{
+    // Only retireAt entries can be ahead of the current value
+    auto position = std::upper_bound(m_entries.begin(), m_entries.end(), entry.value,
+        [](uint64_t value, const Entry& other) { return value < other.value; });
+    m_entries.insert(position, std::move(entry));
+}
+
+void DeletionQueue::setCurrentValue(uint64_t value)
+{
+    std::lock_guard lock(m_mutex);
+    m_currentValue = value;
+}
+
+void DeletionQueue::collect(uint64_t completedValue)
+{
+    PROFILE_ZONE("DeletionQueue::collect");
+    std::unique_lock lock(m_mutex);
+    while (!m_entries.empty() && m_entries.front().value <= completedValue)
+    {
+        Entry entry = std::move(m_entries.front());
+        m_entries.pop_front();
+
+        // Release callbacks may retire further resources
+        lock.unlock();
+        Destroy(entry);
+        lock.lock();
+    }
+}
+
+void DeletionQueue::retireBuffer(VkBuffer buffer, VmaAllocation allocation)
+{
+    push(Entry{ .buffer = buffer, .allocation = allocation });
+}
+
+void DeletionQueue::retireImage(VkImage image, VmaAllocation allocation, vk::raii::ImageView&& view)
+{
+    push(Entry{ .image = image, .allocation = allocation, .view = std::move(view) });
+}
+
+void DeletionQueue::retire(std::function<void()> release)
+{
+    push(Entry{ .release = std::move(release) });
+}
+
+void DeletionQueue::retireAt(uint64_t value, std::function<void()> release)
+{
+    std::lock_guard lock(m_mutex);
+    insert(Entry{ .value = value, .release = std::move(release) });
+}
+
+void DeletionQueue::flush()
+{
+    collect(UINT64_MAX);
+}
+
+size_t DeletionQueue::size()
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
@@ -0,0 +1,180 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/memory/frame_arena.h"
+
+#include <cstdlib>
+#include <new>
+
+void LinearArena::grow(size_t bytes, size_t alignment)
+{
+    size_t size = std::max(m_blockSize, bytes + alignment);
+    std::byte* data = static_cast<std::byte*>(::operator new(size));
+    m_blocks.push_back({ data, size });
+    mp_head = data;
+    mp_end = data + size;
+}
+
+void LinearArena::release()
+{
+    for (Block& block : m_blocks)
+        ::operator delete(block.data);
+    m_blocks.clear();
+    mp_head = mp_end = nullptr;
+}
+
+void* LinearArena::do_allocate(size_t bytes, size_t alignment)
+{
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(mp_head) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+
+    if (!mp_head || aligned + bytes > reinterpret_cast<uintptr_t>(mp_end))
+    {
+        grow(bytes, alignment);
+        aligned = (reinterpret_cast<uintptr_t>(mp_head) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    }
+
+    mp_head = reinterpret_cast<std::byte*>(aligned + bytes);
+    m_used += bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void LinearArena::reset()
+{
+    m_peak = std::max(m_peak, m_used);
+    m_used = 0;
+
+    if (m_blocks.size() > 1)
+    {
+        size_t total = 0;
+        for (const Block& block : m_blocks)
+            total += block.size;
+        release();
+        m_blockSize = std::max(m_blockSize, total);
+    }
+
+    if (!m_blocks.empty())
+    {
+        mp_head = m_blocks.front().data;
+        mp_end = mp_head + m_blocks.front().size;
+    }
+}
+
+void FrameAllocator::beginFrame(uint32_t frameIndex)
+{
+    m_arenas[frameIndex].reset();
+    m_epochs[frameIndex].fetch_add(1, std::memory_order_release);
+    m_frameIndex.store(frameIndex, std::memory_order_relaxed);
+}
+
+LinearArena& FrameAllocator::threadLocal()
+{
+    struct ThreadArenas
+    {
+        std::array<LinearArena, MAX_FRAMES_IN_FLIGHT> arenas;
+        std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> epochs{};
+    };
+    thread_local ThreadArenas local;
+
+    uint32_t frameIndex = m_frameIndex.load(std::memory_order_relaxed);
+    uint64_t epoch = m_epochs[frameIndex].load(std::memory_order_acquire);
+
+    // Reset lazily on first use in a new frame, only the owning thread touches these arenas
+    if (local.epochs[frameIndex] != epoch)
+    {
+        local.arenas[frameIndex].reset();
+        local.epochs[frameIndex] = epoch;
+    }
+    return local.arenas[frameIndex];
+}
+
+#ifdef THEWHEEL_PROFILING
+static std::atomic<uint64_t> heapAllocationCount{ 0 };
+
+uint64_t HeapStats::GetAllocationCount()
+{
+    return heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+// Counting replacements of the global allocation functions (nothrow forms forward here)
+void* operator new(size_t size)
+{
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Over-aligned types (alignas > __STDCPP_DEFAULT_NEW_ALIGNMENT__) come through these
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    if (void* ptr = _aligned_malloc(size ? size : 1, align))
+        return ptr;
+#else
+    // aligned_alloc wants the size to be a multiple of the alignment
+    if (void* ptr = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) & ~(align - 1)))
+        return ptr;
+#endif
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    ::operator delete(ptr, alignment);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(ptr, alignment);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(ptr, alignment);
+}
+#else
+uint64_t HeapStats::GetAllocationCount()
+{
+    return 0;
+}
+#endif
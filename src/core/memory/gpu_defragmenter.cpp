@@ -0,0 +1,340 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/memory/gpu_defragmenter.h"
+#include "core/profiling/cpu_profiler.h"
+
+#include <chrono>
+
+// Passes per run before giving up on allocations that keep being skipped (e.g. unmovable ones)
+constexpr uint32_t DEFRAG_MAX_PASSES = 32;
+
+void Defragmenter::init(vk::raii::Device& device, BindlessRegistry& bindless, FrameScheduler& scheduler, const DefragConfig& config)
+{
+    mp_device = &device;
+    mp_bindless = &bindless;
+    mp_scheduler = &scheduler;
+    m_config = config;
+    m_framesLeft = m_config.checkInterval;
+}
+
+bool Defragmenter::isFragmented(MType pool) const
+{
+    VmaDetailedStatistics stats = Allocator::GetPoolStats(pool);
+    // A single block can't be released, so compacting it gains nothing
+    if (stats.statistics.blockCount < 2)
+        return false;
+
+    VkDeviceSize freeBytes = stats.statistics.blockBytes - stats.statistics.allocationBytes;
+    return freeBytes > static_cast<VkDeviceSize>(m_config.minFreeRatio * stats.statistics.blockBytes);
+}
+
+void Defragmenter::begin(MType pool)
+{
+    VmaDefragmentationInfo info = {};
+    info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+    info.pool = Allocator::GetPool(pool);
+    info.maxBytesPerPass = m_config.maxBytesPerPass;
+    info.maxAllocationsPerPass = m_config.maxMovesPerPass;
+
+    if (vmaBeginDefragmentation(Allocator::GetAllocator(), &info, &m_context) != VK_SUCCESS)
+        throw std::runtime_error("<Defragmenter> vmaBeginDefragmentation failed");
+
+    m_pool = pool;
+    m_passCount = 0;
+    m_state = Ready;
+    m_stats.runs++;
+}
+
+void Defragmenter::update()
+{
+    if (!m_config.enabled)
+        return;
+
+    switch (m_state)
+    {
+    case Idle:
+        if (m_framesLeft > 0)
+        {
+            m_framesLeft--;
+            return;
+        }
+
+        m_framesLeft = m_config.checkInterval;
+        for (MType pool : { MeshMemory, TextureMemory })
+        {
+            if (isFragmented(pool))
+            {
+                begin(pool);
+                beginPass();
+                break;
+            }
+        }
+        break;
+
+    case Ready:
+        beginPass();
+        break;
+
+    case Copying:
+        if (m_copyFence.getStatus() != vk::Result::eSuccess)
+            return;
+
+        swapMoved();
+        // Frames recorded before the swap may still read the old resources
+        m_state = Retiring;
+        m_retireFrame = mp_scheduler->getFrameNumber() - 1;
+        break;
+
+    case Retiring:
+        if (!mp_scheduler->isComplete(m_retireFrame))
+            return;
+
+        destroyRetired();
+        endPass();
+        break;
+    }
+}
+
+void Defragmenter::beginPass()
+{
+    PROFILE_ZONE("Defragmenter::beginPass");
+    VkResult result = vmaBeginDefragmentationPass(Allocator::GetAllocator(), m_context, &m_pass);
+    if (result == VK_SUCCESS)
+    {
+        // Nothing left to move
+        end();
+        return;
+    }
+    if (result != VK_INCOMPLETE)
+        throw std::runtime_error("<Defragmenter> vmaBeginDefragmentationPass failed");
+
+    m_stats.passes++;
+    if (m_pool == TextureMemory)
+        moveTextures();
+    else
+        moveBuffers();
+}
+
+//@brief Milliseconds since start
+static double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Defragmenter::moveBuffers()
+{
+    auto start = std::chrono::steady_clock::now();
+    m_swaps.clear();
+    vk::raii::CommandBuffer cmd = CommandBuffer::BeginSingleUse(*mp_device, QType::Transfer);
+
+    for (uint32_t i = 0; i < m_pass.moveCount; i++)
+    {
+        VmaDefragmentationMove& move = m_pass.pMoves[i];
+        VmaAllocationInfo info{};
+        vmaGetAllocationInfo(Allocator::GetAllocator(), move.srcAllocation, &info);
+        Buffer* owner = static_cast<Buffer*>(info.pUserData);
+
+        // Skipped moves stay where they are and are offered again by a later pass
+        if (!owner || !owner->isMovable() || ElapsedMs(start) > m_config.budgetMs)
+        {
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+
+        VkBuffer moved = owner->createMoved(move.dstTmpAllocation);
+        cmd.copyBuffer(owner->getBuffer(), moved, vk::BufferCopy{ .srcOffset = 0, .dstOffset = 0, .size = owner->getSize() });
+        m_swaps.emplace_back(owner, moved);
+    }
+
+    if (m_swaps.empty())
+    {
+        endPass();
+        return;
+    }
+
+    m_copyFence = vk::raii::Fence(*mp_device, vk::FenceCreateInfo{});
+    CommandBuffer::EndSingleUse(cmd, QType::Transfer, &m_copyFence);
+    m_copyCmd = std::move(cmd);
+    m_state = Copying;
+}
+
+void Defragmenter::moveTextures()
+{
+    auto start = std::chrono::steady_clock::now();
+    m_textureSwaps.clear();
+    // Layout transitions need shader stages, so the copy runs on the graphics queue, ordered after
+    // the frames already submitted and before the one being recorded
+    vk::raii::CommandBuffer cmd = CommandBuffer::BeginSingleUse(*mp_device, QType::Graphics);
+
+    for (uint32_t i = 0; i < m_pass.moveCount; i++)
+    {
+        VmaDefragmentationMove& move = m_pass.pMoves[i];
+        VmaAllocationInfo info{};
+        vmaGetAllocationInfo(Allocator::GetAllocator(), move.srcAllocation, &info);
+        ImageBuffer* owner = static_cast<ImageBuffer*>(info.pUserData);
+
+        if (!owner || ElapsedMs(start) > m_config.budgetMs)
+        {
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+
+        VkImage source = owner->getImage();
+        VkImage image = owner->createMoved(move.dstTmpAllocation);
+        VkExtent3D extent = owner->getExtent();
+        ImageBuffer::RecordTransition(cmd, source, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        ImageBuffer::RecordTransition(cmd, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        cmd.copyImage(
+            source, vk::ImageLayout::eTransferSrcOptimal,
+            image, vk::ImageLayout::eTransferDstOptimal,
+            vk::ImageCopy{
+                .srcSubresource = { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+                .dstSubresource = { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+                .extent = { extent.width, extent.height, extent.depth }
+            });
+        ImageBuffer::RecordTransition(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        // Frames recorded before the swap keep sampling the source
+        ImageBuffer::RecordTransition(cmd, source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        m_textureSwaps.emplace_back(owner, image);
+    }
+
+    if (m_textureSwaps.empty())
+    {
+        endPass();
+        return;
+    }
+
+    m_copyFence = vk::raii::Fence(*mp_device, vk::FenceCreateInfo{});
+    CommandBuffer::EndSingleUse(cmd, QType::Graphics, &m_copyFence);
+    m_copyCmd = std::move(cmd);
+    m_state = Copying;
+}
+
+void Defragmenter::swapTextures()
+{
+    DeletionQueue& deletionQueue = Core::GetInstance().getDeletionQueue();
+    for (auto& [owner, image] : m_textureSwaps)
+    {
+        vk::raii::ImageView previousView = nullptr;
+        VkImage previous = owner->swapImage(*mp_device, image, previousView);
+        // The old memory returns to VMA when the pass ends, so only the image and view are retired
+        deletionQueue.retireImage(previous, VK_NULL_HANDLE, std::move(previousView));
+
+        // Pending frames keep sampling the old slot, frames recorded from now on use a fresh one
+        uint32_t previousSlot = owner->getBindlessIndex();
+        if (previousSlot == BINDLESS_INVALID_INDEX)
+            continue;
+
+        uint32_t slot = mp_bindless->registerTexture(owner->getView());
+        owner->setBindlessIndex(slot);
+        Core::GetInstance().getGpuScene().replaceMaterial(previousSlot, slot);
+        deletionQueue.retire([previousSlot]() { Core::GetInstance().getBindlessRegistry().releaseTexture(previousSlot); });
+    }
+    m_textureSwaps.clear();
+    m_copyCmd = nullptr;
+    m_copyFence = nullptr;
+}
+
+void Defragmenter::swapMoved()
+{
+    if (m_pool == TextureMemory)
+        swapTextures();
+    else
+        swapBuffers();
+}
+
+void Defragmenter::swapBuffers()
+{
+    for (auto& [owner, buffer] : m_swaps)
+        m_retired.push_back(owner->swapBuffer(buffer));
+    m_swaps.clear();
+    m_copyCmd = nullptr;
+    m_copyFence = nullptr;
+}
+
+void Defragmenter::destroyRetired()
+{
+    for (VkBuffer buffer : m_retired)
+        vk::Device(**mp_device).destroyBuffer(buffer, Allocator::GetHostCallbacks());
+    m_retired.clear();
+}
+
+bool Defragmenter::inPass(VmaAllocation allocation) const
+{
+    // Ignored moves count too, vmaEndDefragmentationPass reads every source allocation
+    for (uint32_t i = 0; i < m_pass.moveCount; i++)
+    {
+        if (m_pass.pMoves[i].srcAllocation == allocation)
+            return true;
+    }
+    return false;
+}
+
+void Defragmenter::endPass()
+{
+    m_passCount++;
+    VkResult result = vmaEndDefragmentationPass(Allocator::GetAllocator(), m_context, &m_pass);
+    if (result == VK_SUCCESS || m_passCount >= DEFRAG_MAX_PASSES)
+        end();
+    else
+        m_state = Ready;
+}
+
+void Defragmenter::end()
+{
+    VmaDefragmentationStats stats = {};
+    vmaEndDefragmentation(Allocator::GetAllocator(), m_context, &stats);
+    m_context = VK_NULL_HANDLE;
+    m_pass = {};
+
+    m_stats.moves += stats.allocationsMoved;
+    m_stats.bytesMoved += stats.bytesMoved;
+    m_stats.blocksFreed += stats.deviceMemoryBlocksFreed;
+    m_state = Idle;
+    m_framesLeft = m_config.checkInterval;
+}
+
+void Defragmenter::release(VmaAllocation allocation)
+{
+    if ((m_state != Copying && m_state != Retiring) || !inPass(allocation))
+        return;
+
+    PROFILE_ZONE("Defragmenter::release");
+    if (m_state == Copying)
+    {
+        while (vk::Result::eTimeout == mp_device->waitForFences(*m_copyFence, vk::True, UINT64_MAX));
+        swapMoved();
+        m_retireFrame = mp_scheduler->getFrameNumber() - 1;
+    }
+
+    // VMA must not see the allocation freed before the pass ends
+    mp_scheduler->wait(m_retireFrame);
+    destroyRetired();
+    endPass();
+}
+
+void Defragmenter::finish()
+{
+    if (m_state == Copying)
+    {
+        while (vk::Result::eTimeout == mp_device->waitForFences(*m_copyFence, vk::True, UINT64_MAX));
+        swapMoved();
+        m_state = Retiring;
+    }
+
+    if (m_state == Retiring)
+    {
+        destroyRetired();
+        endPass();
+    }
+
+    if (m_context)
+        end();
+}
+
+void Defragmenter::printStats(std::ostream& out) const
+{
+    out << "Defragmentation: " << m_stats.runs << " runs, " << m_stats.passes << " passes, "
+        << m_stats.moves << " moves, " << m_stats.bytesMoved / (1024.0 * 1024.0) << " MiB moved, "
+        << m_stats.blocksFreed << " blocks freed" << std::endl;
+}
@@ -0,0 +1,142 @@
+#include "core/profiling/cpu_profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct CollectedEvent
+    {
+        Profiler::ZoneEvent zone;
+        uint32_t threadId;
+    };
+
+    // Buffers are owned by the registry so events survive their thread
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<Profiler::ThreadBuffer>> threadBuffers;
+    std::vector<CollectedEvent> collected;
+    uint64_t captureStartNs = 0;
+
+    constexpr size_t MAX_COLLECTED_EVENTS = 1 << 24;
+
+    void WriteEscaped(std::ofstream& out, const char* str)
+    {
+        for (; *str; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+                out << '\\';
+            out << *str;
+        }
+    }
+}
+
+Profiler::ThreadBuffer* Profiler::RegisterThread()
+{
+    std::lock_guard lock(registryMutex);
+    threadBuffers.push_back(std::make_unique<ThreadBuffer>());
+    tl_buffer = threadBuffers.back().get();
+    tl_buffer->threadId = static_cast<uint32_t>(threadBuffers.size());
+    return tl_buffer;
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    ThreadBuffer* buffer = tl_buffer ? tl_buffer : RegisterThread();
+    buffer->threadName = name;
+}
+
+void Profiler::StartCapture()
+{
+    {
+        std::lock_guard lock(registryMutex);
+        collected.clear();
+        for (auto& buffer : threadBuffers)
+        {
+            buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+            buffer->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+    captureStartNs = Now();
+    g_capturing.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::Collect()
+{
+    std::lock_guard lock(registryMutex);
+    for (auto& buffer : threadBuffers)
+    {
+        uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+
+        for (; tail != head && collected.size() < MAX_COLLECTED_EVENTS; ++tail)
+            collected.push_back({ buffer->events[tail & (ThreadBuffer::CAPACITY - 1)], buffer->threadId });
+        // Events past the capture limit are discarded with the rest of the ring
+        if (tail != head)
+            buffer->dropped.fetch_add(head - tail, std::memory_order_relaxed);
+
+        buffer->tail.store(head, std::memory_order_release);
+    }
+}
+
+bool Profiler::StopCapture(const std::string& path, TraceFormat format)
+{
+    g_capturing.store(false, std::memory_order_relaxed);
+    Collect();
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open())
+    {
+        std::cerr << "<Profiler> failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard lock(registryMutex);
+    out << "{";
+    if (format == TraceFormat::PerfettoJson)
+        out << "\"displayTimeUnit\":\"ns\",";
+    out << "\"traceEvents\":[\n";
+
+    bool first = true;
+    uint64_t dropped = 0;
+    for (auto& buffer : threadBuffers)
+    {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        if (!buffer->threadName)
+            continue;
+
+        out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+            << buffer->threadId << ",\"args\":{\"name\":\"";
+        WriteEscaped(out, buffer->threadName);
+        out << "\"}}";
+        first = false;
+    }
+
+    out.precision(3);
+    out << std::fixed;
+    for (const CollectedEvent& e : collected)
+    {
+        // Zones opened before the capture started are clipped to its start (the offset is unsigned)
+        uint64_t beginNs = std::max(e.zone.beginNs, captureStartNs);
+        // Chrome trace timestamps are in microseconds
+        out << (first ? "" : ",\n") << "{\"ph\":\"X\",\"name\":\"";
+        WriteEscaped(out, e.zone.name);
+        out << "\",\"pid\":1,\"tid\":" << e.threadId
+            << ",\"ts\":" << static_cast<double>(beginNs - captureStartNs) * 1e-3
+            << ",\"dur\":" << static_cast<double>(std::max(e.zone.endNs, beginNs) - beginNs) * 1e-3 << "}";
+        first = false;
+    }
+    out << "\n]";
+    if (format == TraceFormat::PerfettoJson)
+        out << ",\"metadata\":{\"dropped-events\":" << dropped << "}";
+    out << "}\n";
+
+    if (dropped > 0)
+        std::cerr << "<Profiler> dropped " << dropped << " zones (ring buffer or capture full)" << std::endl;
+
+    collected.clear();
+    return true;
+}
@@ -0,0 +1,46 @@
+#include "core/profiling/frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+    size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+FrameTimeSummary FrameStats::summarize() const
+{
+    FrameTimeSummary summary{};
+    if (m_frameTimes.empty())
+        return summary;
+
+    std::vector<double> sorted = m_frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    summary.count = sorted.size();
+    summary.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+    summary.min = sorted.front();
+    summary.max = sorted.back();
+    summary.p50 = Percentile(sorted, 0.50);
+    summary.p95 = Percentile(sorted, 0.95);
+    summary.p99 = Percentile(sorted, 0.99);
+    return summary;
+}
+
+void FrameStats::print(std::ostream& out, const char* label) const
+{
+    FrameTimeSummary s = summarize();
+    out << "-----" << label << "-----\n"
+        << std::fixed << std::setprecision(3)
+        << "frames: " << s.count << "\n"
+        << "mean:   " << s.mean << " ms (" << (s.mean > 0.0 ? 1000.0 / s.mean : 0.0) << " fps)\n"
+        << "min:    " << s.min << " ms\n"
+        << "max:    " << s.max << " ms\n"
+        << "p50:    " << s.p50 << " ms\n"
+        << "p95:    " << s.p95 << " ms\n"
+        << "p99:    " << s.p99 << " ms\n"
+        << "--------------------" << std::endl;
+}
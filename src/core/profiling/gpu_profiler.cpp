@@ -0,0 +1,178 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/profiling/gpu_profiler.h"
+
+#include <iomanip>
+
+void GpuProfiler::init(
+    vk::raii::Device& device,
+    vk::raii::PhysicalDevice& physicalDevice,
+    uint32_t queueFamilyIndex,
+    bool debugLabels,
+    uint32_t maxScopes)
+{
+    vk::PhysicalDeviceLimits limits = physicalDevice.getProperties().limits;
+    uint32_t validBits = physicalDevice.getQueueFamilyProperties()[queueFamilyIndex].timestampValidBits;
+
+    m_debugLabels = debugLabels;
+    m_maxQueries = maxScopes * 2;
+    m_timestampPeriod = static_cast<double>(limits.timestampPeriod);
+    m_timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+    m_supported = validBits > 0 && limits.timestampPeriod > 0.0f;
+
+    if constexpr (DISPLAY_VULKAN_INFO)
+        if (!m_supported)
+            std::cout << "GpuProfiler: timestamps unsupported on queue family " << queueFamilyIndex << std::endl;
+
+    if (!m_supported)
+        return;
+
+    for (FrameQueries& frame : m_frames)
+    {
+        frame.pool = vk::raii::QueryPool(device, vk::QueryPoolCreateInfo{
+            .queryType = vk::QueryType::eTimestamp,
+            .queryCount = m_maxQueries
+        });
+        frame.scopes.reserve(maxScopes);
+    }
+}
+
+void GpuProfiler::resolve()
+{
+    FrameQueries& frame = m_frames[m_frameIndex];
+    if (frame.queryCount == 0)
+        return;
+
+    // The frame slot's fence has already signaled, so the results are available without waiting
+    auto [result, values] = frame.pool.getResults<uint64_t>(
+        0,
+        frame.queryCount,
+        frame.queryCount * sizeof(uint64_t),
+        sizeof(uint64_t),
+        vk::QueryResultFlagBits::e64);
+
+    if (result != vk::Result::eSuccess)
+        return;
+
+    std::vector<GpuPassTiming> timings;
+    timings.reserve(frame.scopes.size());
+
+    uint64_t first = ~0ull, last = 0;
+    for (const Scope& scope : frame.scopes)
+    {
+        uint64_t begin = values[scope.beginQuery] & m_timestampMask;
+        uint64_t end = values[scope.endQuery] & m_timestampMask;
+        double ms = end > begin ? static_cast<double>(end - begin) * m_timestampPeriod * 1e-6 : 0.0;
+
+        // Exponential moving average keyed by the (static) scope name
+        double avgMs = ms;
+        for (const GpuPassTiming& prev : m_timings)
+        {
+            if (prev.name == scope.name)
+            {
+                avgMs = prev.avgMs * 0.9 + ms * 0.1;
+                break;
+            }
+        }
+
+        timings.push_back({ .name = scope.name, .depth = scope.depth, .ms = ms, .avgMs = avgMs });
+        first = std::min(first, begin);
+        last = std::max(last, end);
+    }
+
+    m_frameMs = last > first ? static_cast<double>(last - first) * m_timestampPeriod * 1e-6 : 0.0;
+    m_frameBegin = first;
+    m_frameEnd = last;
+    m_timings = std::move(timings);
+}
+
+double GpuProfiler::OverlapMs(const GpuProfiler& a, const GpuProfiler& b)
+{
+    uint64_t begin = std::max(a.m_frameBegin, b.m_frameBegin);
+    uint64_t end = std::min(a.m_frameEnd, b.m_frameEnd);
+    return end > begin ? static_cast<double>(end - begin) * a.m_timestampPeriod * 1e-6 : 0.0;
+}
+
+void GpuProfiler::beginFrame(vk::raii::CommandBuffer& cmd, uint32_t frameIndex)
+{
+    m_frameIndex = frameIndex;
+    m_openScopes.clear();
+
+    if (!m_supported)
+        return;
+
+    resolve();
+
+    FrameQueries& frame = m_frames[m_frameIndex];
+    frame.scopes.clear();
+    frame.queryCount = 0;
+    cmd.resetQueryPool(*frame.pool, 0, m_maxQueries);
+}
+
+void GpuProfiler::beginScope(vk::raii::CommandBuffer& cmd, const char* name)
+{
+    if (m_debugLabels)
+        cmd.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT{ .pLabelName = name });
+
+    if (!m_supported)
+        return;
+
+    FrameQueries& frame = m_frames[m_frameIndex];
+    if (frame.queryCount + 2 > m_maxQueries)
+    {
+        // Out of queries, keep the scope stack balanced but don't time it
+        m_openScopes.push_back(UINT32_MAX);
+        return;
+    }
+
+    m_openScopes.push_back(static_cast<uint32_t>(frame.scopes.size()));
+    frame.scopes.push_back({
+        .name = name,
+        .beginQuery = frame.queryCount++,
+        .endQuery = frame.queryCount++,
+        .depth = static_cast<uint32_t>(m_openScopes.size() - 1)
+    });
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, *frame.pool, frame.scopes.back().beginQuery);
+}
+
+void GpuProfiler::endScope(vk::raii::CommandBuffer& cmd)
+{
+    if (m_supported && !m_openScopes.empty())
+    {
+        uint32_t scopeIndex = m_openScopes.back();
+        m_openScopes.pop_back();
+
+        if (scopeIndex != UINT32_MAX)
+        {
+            FrameQueries& frame = m_frames[m_frameIndex];
+            cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, *frame.pool, frame.scopes[scopeIndex].endQuery);
+        }
+    }
+
+    if (m_debugLabels)
+        cmd.endDebugUtilsLabelEXT();
+}
+
+void GpuProfiler::printTimings(std::ostream& out) const
+{
+    out << "-----GPU Passes-----\n";
+    for (const GpuPassTiming& timing : m_timings)
+    {
+        out << std::string(timing.depth * 2, ' ') << timing.name << ": "
+            << std::fixed << std::setprecision(3) << timing.ms << " ms (avg "
+            << timing.avgMs << " ms)\n";
+    }
+    out << "Frame: " << std::fixed << std::setprecision(3) << m_frameMs << " ms\n";
+    out << "--------------------" << std::endl;
+}
+
+void GpuProfiler::clean()
+{
+    for (FrameQueries& frame : m_frames)
+    {
+        frame.pool = nullptr;
+        frame.scopes.clear();
+        frame.queryCount = 0;
+    }
+    m_timings.clear();
+}
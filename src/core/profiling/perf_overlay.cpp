@@ -0,0 +1,217 @@
+#include "core/core_pch.h"
+#include <SDL3/SDL.h>
+#include "core/engine.h"
+#include "core/profiling/perf_overlay.h"
+#include "core/profiling/cpu_profiler.h"
+#include "core/system/event_handler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <imgui.h>
+#include <imgui_impl_sdl3.h>
+#include <imgui_impl_vulkan.h>
+
+// Frames between heap budget queries
+constexpr uint32_t OVERLAY_HEAP_REFRESH = 30;
+constexpr float OVERLAY_GRAPH_WIDTH = 260.0f;
+constexpr float OVERLAY_GRAPH_HEIGHT = 48.0f;
+
+void PerfOverlay::KeyDownCallback(SDL_Event* event)
+{
+    if (event->key.key == SDLK_F1 && !event->key.repeat)
+        m_visible = !m_visible;
+    InputCallback(event);
+}
+
+void PerfOverlay::InputCallback(SDL_Event* event)
+{
+    if (m_visible && ImGui::GetCurrentContext())
+        ImGui_ImplSDL3_ProcessEvent(event);
+}
+
+void PerfOverlay::init(
+    SDL_Window* window,
+    vk::raii::Instance& instance,
+    vk::raii::PhysicalDevice& physicalDevice,
+    vk::raii::Device& device,
+    uint32_t queueFamilyIndex,
+    vk::raii::Queue& queue,
+    vk::Format colorFormat,
+    uint32_t imageCount,
+    bool visible)
+{
+    // The backend allocates its font texture set from here
+    vk::DescriptorPoolSize poolSize{ .type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = 8 };
+    m_descriptorPool = vk::raii::DescriptorPool(device, vk::DescriptorPoolCreateInfo{
+        .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+        .maxSets = 8,
+        .poolSizeCount = 1,
+        .pPoolSizes = &poolSize
+    });
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    // HUD placement is not persisted
+    io.IniFilename = nullptr;
+    ImGui::StyleColorsDark();
+
+    if (!ImGui_ImplSDL3_InitForVulkan(window))
+        throw std::runtime_error("<PerfOverlay> failed to initialize the SDL3 backend");
+
+    m_colorFormat = static_cast<VkFormat>(colorFormat);
+    ImGui_ImplVulkan_InitInfo info = {};
+    info.Instance = *instance;
+    info.PhysicalDevice = *physicalDevice;
+    info.Device = *device;
+    info.QueueFamily = queueFamilyIndex;
+    info.Queue = *queue;
+    info.DescriptorPool = *m_descriptorPool;
+    info.MinImageCount = std::max(2u, imageCount);
+    info.ImageCount = std::max(2u, imageCount);
+    info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+    info.UseDynamicRendering = true;
+    info.PipelineRenderingCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &m_colorFormat
+    };
+
+    if (!ImGui_ImplVulkan_Init(&info))
+        throw std::runtime_error("<PerfOverlay> failed to initialize the Vulkan backend");
+
+    // Mouse input only matters while the HUD is shown (to move or collapse it)
+    EventHandler::SubToEvent(SDL_EVENT_KEY_DOWN, KeyDownCallback);
+    EventHandler::SubToEvent(SDL_EVENT_KEY_UP, InputCallback);
+    EventHandler::SubToEvent(SDL_EVENT_MOUSE_MOTION, InputCallback);
+    EventHandler::SubToEvent(SDL_EVENT_MOUSE_BUTTON_DOWN, InputCallback);
+    EventHandler::SubToEvent(SDL_EVENT_MOUSE_BUTTON_UP, InputCallback);
+    EventHandler::SubToEvent(SDL_EVENT_MOUSE_WHEEL, InputCallback);
+
+    m_visible = visible;
+    m_initialized = true;
+}
+
+//@brief Milliseconds since start
+static double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PerfOverlay::beginFrame(const OverlayFrameStats& stats)
+{
+    m_frameBuilt = false;
+    if (!isVisible())
+        return;
+
+    PROFILE_ZONE("PerfOverlay::beginFrame");
+    auto start = std::chrono::steady_clock::now();
+
+    m_cpuHistory[m_historyIndex] = static_cast<float>(stats.cpuFrameMs);
+    m_gpuHistory[m_historyIndex] = static_cast<float>(stats.gpuFrameMs);
+    m_historyIndex = (m_historyIndex + 1) % OVERLAY_HISTORY;
+
+    for (const GpuPassTiming& pass : stats.passes)
+        if (strcmp(pass.name, OVERLAY_SCOPE) == 0)
+            m_gpuOverheadMs = pass.avgMs;
+
+    // Budgets come from the driver, a few refreshes per second are plenty
+    if (m_framesUntilHeapRefresh == 0)
+    {
+        m_heaps = Allocator::GetHeapUsage();
+        m_framesUntilHeapRefresh = OVERLAY_HEAP_REFRESH;
+    }
+    m_framesUntilHeapRefresh--;
+
+    ImGui_ImplVulkan_NewFrame();
+    ImGui_ImplSDL3_NewFrame();
+    ImGui::NewFrame();
+    buildWindow(stats);
+    ImGui::Render();
+
+    m_buildMs = ElapsedMs(start);
+    m_frameBuilt = true;
+}
+
+void PerfOverlay::buildWindow(const OverlayFrameStats& stats)
+{
+    constexpr double MiB = 1024.0 * 1024.0;
+    char label[64];
+
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.75f);
+    ImGui::Begin("Performance (F1)", nullptr,
+        ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+
+    // Both graphs share a scale so CPU and GPU bound frames are told apart at a glance
+    float peak = std::max(
+        *std::max_element(m_cpuHistory.begin(), m_cpuHistory.end()),
+        *std::max_element(m_gpuHistory.begin(), m_gpuHistory.end()));
+    float scaleMax = std::max(1000.0f / 60.0f, peak * 1.1f);
+
+    snprintf(label, sizeof(label), "CPU %.2f ms", stats.cpuFrameMs);
+    ImGui::PlotLines("##cpu", m_cpuHistory.data(), OVERLAY_HISTORY, m_historyIndex, label,
+        0.0f, scaleMax, ImVec2(OVERLAY_GRAPH_WIDTH, OVERLAY_GRAPH_HEIGHT));
+    snprintf(label, sizeof(label), "GPU %.2f ms", stats.gpuFrameMs);
+    ImGui::PlotLines("##gpu", m_gpuHistory.data(), OVERLAY_HISTORY, m_historyIndex, label,
+        0.0f, scaleMax, ImVec2(OVERLAY_GRAPH_WIDTH, OVERLAY_GRAPH_HEIGHT));
+
+    if (ImGui::CollapsingHeader("GPU passes", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        for (const GpuPassTiming& pass : stats.passes)
+            ImGui::Text("%*s%-16s %7.3f ms", static_cast<int>(pass.depth * 2), "", pass.name, pass.avgMs);
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Draws %u   Triangles %llu", stats.draws, static_cast<unsigned long long>(stats.triangles));
+    ImGui::Text("Uploads %.1f KiB/frame", static_cast<double>(stats.uploadBytes) / 1024.0);
+    if (stats.latencyMs > 0.0)
+        ImGui::Text("Input latency %.1f ms", stats.latencyMs);
+
+    for (const HeapUsage& heap : m_heaps)
+    {
+        if (!heap.deviceLocal || heap.budget == 0)
+            continue;
+        snprintf(label, sizeof(label), "Heap %u: %.0f / %.0f MiB", heap.heapIndex, heap.usage / MiB, heap.budget / MiB);
+        ImGui::ProgressBar(static_cast<float>(static_cast<double>(heap.usage) / heap.budget), ImVec2(OVERLAY_GRAPH_WIDTH, 0.0f), label);
+    }
+
+    ImGui::Separator();
+    bool overBudget = m_cpuOverheadMs + m_gpuOverheadMs > OVERLAY_BUDGET_MS;
+    ImGui::TextColored(overBudget ? ImVec4(1.0f, 0.4f, 0.3f, 1.0f) : ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
+        "Overlay %.3f ms CPU, %.3f ms GPU", m_cpuOverheadMs, m_gpuOverheadMs);
+
+    ImGui::End();
+}
+
+void PerfOverlay::record(vk::raii::CommandBuffer& cmd)
+{
+    if (!m_frameBuilt)
+        return;
+
+    PROFILE_ZONE("PerfOverlay::record");
+    auto start = std::chrono::steady_clock::now();
+    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), *cmd);
+
+    // Smoothed so the readout stays legible
+    double frameMs = m_buildMs + ElapsedMs(start);
+    m_cpuOverheadMs = m_cpuOverheadMs == 0.0 ? frameMs : m_cpuOverheadMs * 0.95 + frameMs * 0.05;
+    m_frameBuilt = false;
+}
+
+void PerfOverlay::clean()
+{
+    if (!m_initialized)
+        return;
+
+    if constexpr (DISPLAY_VULKAN_INFO)
+        std::cout << "Overlay overhead: " << m_cpuOverheadMs << " ms CPU, " << m_gpuOverheadMs << " ms GPU" << std::endl;
+
+    ImGui_ImplVulkan_Shutdown();
+    ImGui_ImplSDL3_Shutdown();
+    ImGui::DestroyContext();
+    m_descriptorPool = nullptr;
+    m_heaps.clear();
+    m_initialized = false;
+}
@@ -0,0 +1,91 @@
+#include "core/profiling/render_counters.h"
+
+#include <fstream>
+
+namespace
+{
+    constexpr const char* COUNTER_NAMES[RenderCounters::COUNTER_COUNT] = {
+        "draws",
+        "instances",
+        "triangles",
+        "pipeline_binds",
+        "descriptor_binds",
+        "mesh_binds",
+        "barriers",
+        "upload_bytes",
+        "swapchain_recreations",
+        "fence_wait_us"
+    };
+
+    std::vector<RenderCounters::FrameCounters> history;
+}
+
+const char* RenderCounters::GetName(Counter counter)
+{
+    return COUNTER_NAMES[static_cast<size_t>(counter)];
+}
+
+RenderCounters::FrameCounters RenderCounters::Snapshot(uint64_t frame)
+{
+    FrameCounters counters{ .frame = frame };
+    // Adds racing the exchange land in the next frame instead of being lost
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+        counters.values[i] = g_counters[i].value.exchange(0, std::memory_order_relaxed);
+    return counters;
+}
+
+void RenderCounters::Reserve(size_t frameCount)
+{
+    history.reserve(frameCount);
+}
+
+void RenderCounters::Record(const FrameCounters& counters)
+{
+    history.push_back(counters);
+}
+
+void RenderCounters::Clear()
+{
+    history.clear();
+}
+
+const std::vector<RenderCounters::FrameCounters>& RenderCounters::GetHistory()
+{
+    return history;
+}
+
+std::array<double, RenderCounters::COUNTER_COUNT> RenderCounters::GetMeans()
+{
+    std::array<double, COUNTER_COUNT> means = {};
+    if (history.empty())
+        return means;
+
+    for (const FrameCounters& counters : history)
+        for (size_t i = 0; i < COUNTER_COUNT; i++)
+            means[i] += static_cast<double>(counters.values[i]);
+
+    for (double& mean : means)
+        mean /= static_cast<double>(history.size());
+    return means;
+}
+
+bool RenderCounters::WriteCsv(const std::string& path)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    out << "frame";
+    for (const char* name : COUNTER_NAMES)
+        out << ',' << name;
+    out << '\n';
+
+    for (const FrameCounters& counters : history)
+    {
+        out << counters.frame;
+        for (uint64_t value : counters.values)
+            out << ',' << value;
+        out << '\n';
+    }
+    return out.good();
+}
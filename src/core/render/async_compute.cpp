@@ -0,0 +1,166 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/render/async_compute.h"
+#include "core/profiling/cpu_profiler.h"
+
+void AsyncCompute::init(
+    vk::raii::Device& device,
+    vk::raii::PhysicalDevice& physicalDevice,
+    uint32_t queueFamilyIndex,
+    vk::raii::Queue& queue,
+    vk::raii::CommandPool& commandPool,
+    BindlessRegistry& bindless,
+    FrameScheduler& scheduler,
+    bool debugLabels)
+{
+    mp_device = &device;
+    mp_queue = &queue;
+    mp_bindless = &bindless;
+    mp_scheduler = &scheduler;
+    m_submittedValue = 0;
+    m_recording = false;
+
+    vk::raii::CommandBuffers commandBuffers(device, {
+        .commandPool = commandPool,
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = scheduler.getFramesInFlight()
+    });
+    for (uint32_t i = 0; i < commandBuffers.size(); i++)
+        m_commandBuffers[i] = std::move(commandBuffers[i]);
+
+    vk::SemaphoreTypeCreateInfo typeInfo{
+        .semaphoreType = vk::SemaphoreType::eTimeline,
+        .initialValue = 0
+    };
+    m_timeline = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{ .pNext = &typeInfo });
+
+    // Set 0 is unused; compute passes only read the bindless set
+    m_emptyLayout = vk::raii::DescriptorSetLayout(device, vk::DescriptorSetLayoutCreateInfo{});
+    m_profiler.init(device, physicalDevice, queueFamilyIndex, debugLabels);
+}
+
+ComputePipeline AsyncCompute::createPipeline(vk::ShaderModule module, const char* entryPoint, uint32_t pushConstantSize)
+{
+    ComputePipeline pipeline{ .pushConstantSize = pushConstantSize };
+
+    vk::DescriptorSetLayout setLayouts[] = { *m_emptyLayout, *mp_bindless->getLayout() };
+    vk::PushConstantRange pcRange{
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .offset = 0,
+        .size = pushConstantSize
+    };
+
+    pipeline.layout = vk::raii::PipelineLayout(*mp_device, vk::PipelineLayoutCreateInfo{
+        .setLayoutCount = 2,
+        .pSetLayouts = setLayouts,
+        .pushConstantRangeCount = pushConstantSize > 0 ? 1u : 0u,
+        .pPushConstantRanges = &pcRange
+    });
+
+    pipeline.pipeline = vk::raii::Pipeline(*mp_device, nullptr, vk::ComputePipelineCreateInfo{
+        .stage = { .stage = vk::ShaderStageFlagBits::eCompute, .module = module, .pName = entryPoint },
+        .layout = pipeline.layout
+    });
+    return pipeline;
+}
+
+vk::raii::CommandBuffer& AsyncCompute::begin()
+{
+    PROFILE_ZONE("AsyncCompute::begin");
+    if (m_recording)
+        throw std::runtime_error("<AsyncCompute> begin called twice in a frame");
+
+    // Compute values are frame numbers, so the slot's last work is at most framesInFlight frames old
+    uint64_t frameNumber = mp_scheduler->getFrameNumber();
+    uint32_t framesInFlight = mp_scheduler->getFramesInFlight();
+    uint64_t slotValue = frameNumber > framesInFlight ? std::min(frameNumber - framesInFlight, m_submittedValue) : 0;
+    if (slotValue > 0)
+    {
+        vk::SemaphoreWaitInfo waitInfo{
+            .semaphoreCount = 1,
+            .pSemaphores = &*m_timeline,
+            .pValues = &slotValue
+        };
+        if (mp_device->waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+            throw std::runtime_error("<AsyncCompute> timed out waiting for compute work");
+    }
+
+    m_frameIndex = mp_scheduler->getFrameIndex();
+    vk::raii::CommandBuffer& cmd = m_commandBuffers[m_frameIndex];
+    cmd.reset();
+    cmd.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    m_profiler.beginFrame(cmd, m_frameIndex);
+
+    // Submissions on one queue are not ordered in memory, and consecutive frames touch the same buffers
+    vk::MemoryBarrier2 barrier{
+        .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+    };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+
+    m_recording = true;
+    return cmd;
+}
+
+void AsyncCompute::dispatch(const ComputePipeline& pipeline, const void* constants, uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+{
+    vk::raii::CommandBuffer& cmd = m_commandBuffers[m_frameIndex];
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline.pipeline);
+    mp_bindless->bind(cmd, pipeline.layout, vk::PipelineBindPoint::eCompute);
+    if (pipeline.pushConstantSize > 0)
+        cmd.pushConstants(*pipeline.layout, vk::ShaderStageFlagBits::eCompute, 0, pipeline.pushConstantSize, constants);
+    cmd.dispatch(groupsX, groupsY, groupsZ);
+}
+
+uint64_t AsyncCompute::submit(uint64_t waitGraphicsFrame, vk::PipelineStageFlags2 waitStage)
+{
+    PROFILE_ZONE("AsyncCompute::submit");
+    if (!m_recording)
+        throw std::runtime_error("<AsyncCompute> submit called without begin");
+
+    vk::raii::CommandBuffer& cmd = m_commandBuffers[m_frameIndex];
+    cmd.end();
+    m_recording = false;
+
+    uint64_t value = mp_scheduler->getFrameNumber();
+    const vk::SemaphoreSubmitInfo waitInfo = mp_scheduler->getWaitInfo(waitGraphicsFrame, waitStage);
+    const vk::SemaphoreSubmitInfo signalInfo{
+        .semaphore = *m_timeline,
+        .value = value,
+        .stageMask = vk::PipelineStageFlagBits2::eAllCommands
+    };
+    const vk::CommandBufferSubmitInfo commandBufferInfo{ .commandBuffer = *cmd };
+    const vk::SubmitInfo2 submitInfo{
+        .waitSemaphoreInfoCount = waitGraphicsFrame > 0 ? 1u : 0u,
+        .pWaitSemaphoreInfos = &waitInfo,
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &commandBufferInfo,
+        .signalSemaphoreInfoCount = 1,
+        .pSignalSemaphoreInfos = &signalInfo
+    };
+    mp_queue->submit2(submitInfo);
+
+    m_submittedValue = value;
+    return value;
+}
+
+vk::SemaphoreSubmitInfo AsyncCompute::getWaitInfo(uint64_t value, vk::PipelineStageFlags2 stage) const
+{
+    return vk::SemaphoreSubmitInfo{
+        .semaphore = *m_timeline,
+        .value = value,
+        .stageMask = stage
+    };
+}
+
+void AsyncCompute::clean()
+{
+    m_profiler.clean();
+    for (vk::raii::CommandBuffer& cmd : m_commandBuffers)
+        cmd = nullptr;
+    m_emptyLayout = nullptr;
+    m_timeline = nullptr;
+    m_recording = false;
+}
@@ -0,0 +1,169 @@
+#include "core/core_pch.h"
+#include "core/render/bindless_registry.h"
+#include "core/geometry/buffers.h"
+
+#include <array>
+
+uint32_t BindlessRegistry::SlotList::acquire()
+{
+    if (!freeSlots.empty())
+    {
+        uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    if (next >= capacity)
+        throw std::runtime_error("<BindlessRegistry> descriptor array is full");
+
+    return next++;
+}
+
+void BindlessRegistry::SlotList::release(uint32_t slot)
+{
+    if (slot != BINDLESS_INVALID_INDEX)
+        freeSlots.push_back(slot);
+}
+
+void BindlessRegistry::init(vk::raii::Device& device, vk::raii::PhysicalDevice& physicalDevice)
+{
+    mp_device = &device;
+
+    auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+    const vk::PhysicalDeviceVulkan12Properties& limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+    m_textures = { .capacity = std::min({ BINDLESS_MAX_TEXTURES,
+        limits.maxDescriptorSetUpdateAfterBindSampledImages, limits.maxPerStageDescriptorUpdateAfterBindSampledImages }) };
+    m_samplers = { .capacity = std::min({ BINDLESS_MAX_SAMPLERS,
+        limits.maxDescriptorSetUpdateAfterBindSamplers, limits.maxPerStageDescriptorUpdateAfterBindSamplers }) };
+    m_storageBuffers = { .capacity = std::min({ BINDLESS_MAX_STORAGE_BUFFERS,
+        limits.maxDescriptorSetUpdateAfterBindStorageBuffers, limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers }) };
+
+    vk::ShaderStageFlags stages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute;
+    std::array<vk::DescriptorSetLayoutBinding, 3> bindings = {
+        vk::DescriptorSetLayoutBinding(BindlessBinding::Textures, vk::DescriptorType::eSampledImage, m_textures.capacity, stages, nullptr),
+        vk::DescriptorSetLayoutBinding(BindlessBinding::Samplers, vk::DescriptorType::eSampler, m_samplers.capacity, stages, nullptr),
+        vk::DescriptorSetLayoutBinding(BindlessBinding::StorageBuffers, vk::DescriptorType::eStorageBuffer, m_storageBuffers.capacity, stages, nullptr)
+    };
+
+    // Slots are written while the set is bound and unwritten slots are never read
+    vk::DescriptorBindingFlags bindingFlag =
+        vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+        vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending |
+        vk::DescriptorBindingFlagBits::ePartiallyBound;
+    std::array<vk::DescriptorBindingFlags, 3> bindingFlags = { bindingFlag, bindingFlag, bindingFlag };
+
+    vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{
+        .bindingCount = static_cast<uint32_t>(bindingFlags.size()),
+        .pBindingFlags = bindingFlags.data()
+    };
+
+    m_layout = vk::raii::DescriptorSetLayout(device, vk::DescriptorSetLayoutCreateInfo{
+        .pNext = &bindingFlagsInfo,
+        .flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    });
+
+    std::array<vk::DescriptorPoolSize, 3> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, m_textures.capacity),
+        vk::DescriptorPoolSize(vk::DescriptorType::eSampler, m_samplers.capacity),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, m_storageBuffers.capacity)
+    };
+
+    m_pool = vk::raii::DescriptorPool(device, vk::DescriptorPoolCreateInfo{
+        .flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind | vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+        .maxSets = 1,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data()
+    });
+
+    vk::DescriptorSetAllocateInfo allocInfo{
+        .descriptorPool = m_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &*m_layout
+    };
+    m_set = std::move(device.allocateDescriptorSets(allocInfo).front());
+
+    if constexpr (DISPLAY_VULKAN_INFO)
+        std::cout << "Bindless set: " << m_textures.capacity << " textures, " << m_samplers.capacity << " samplers, "
+            << m_storageBuffers.capacity << " storage buffers" << std::endl;
+}
+
+uint32_t BindlessRegistry::registerTexture(vk::ImageView view, vk::ImageLayout layout)
+{
+    uint32_t slot = m_textures.acquire();
+    updateTexture(slot, view, layout);
+    return slot;
+}
+
+void BindlessRegistry::updateTexture(uint32_t slot, vk::ImageView view, vk::ImageLayout layout)
+{
+    vk::DescriptorImageInfo imageInfo{ .imageView = view, .imageLayout = layout };
+
+    mp_device->updateDescriptorSets(vk::WriteDescriptorSet{
+        .dstSet = m_set,
+        .dstBinding = BindlessBinding::Textures,
+        .dstArrayElement = slot,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eSampledImage,
+        .pImageInfo = &imageInfo
+    }, {});
+}
+
+uint32_t BindlessRegistry::registerTexture(ImageBuffer& image)
+{
+    uint32_t slot = registerTexture(image.getView());
+    image.setBindlessIndex(slot);
+    return slot;
+}
+
+uint32_t BindlessRegistry::registerSampler(vk::Sampler sampler)
+{
+    uint32_t slot = m_samplers.acquire();
+    vk::DescriptorImageInfo imageInfo{ .sampler = sampler };
+
+    mp_device->updateDescriptorSets(vk::WriteDescriptorSet{
+        .dstSet = m_set,
+        .dstBinding = BindlessBinding::Samplers,
+        .dstArrayElement = slot,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eSampler,
+        .pImageInfo = &imageInfo
+    }, {});
+
+    return slot;
+}
+
+uint32_t BindlessRegistry::registerStorageBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize range)
+{
+    uint32_t slot = m_storageBuffers.acquire();
+    vk::DescriptorBufferInfo bufferInfo{ .buffer = buffer, .offset = offset, .range = range };
+
+    mp_device->updateDescriptorSets(vk::WriteDescriptorSet{
+        .dstSet = m_set,
+        .dstBinding = BindlessBinding::StorageBuffers,
+        .dstArrayElement = slot,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .pBufferInfo = &bufferInfo
+    }, {});
+
+    return slot;
+}
+
+void BindlessRegistry::bind(vk::raii::CommandBuffer& cmd, const vk::raii::PipelineLayout& layout, vk::PipelineBindPoint bindPoint)
+{
+    cmd.bindDescriptorSets(bindPoint, *layout, BINDLESS_SET, *m_set, {});
+}
+
+void BindlessRegistry::clean()
+{
+    m_set = nullptr;
+    m_pool = nullptr;
+    m_layout = nullptr;
+    m_textures = {};
+    m_samplers = {};
+    m_storageBuffers = {};
+    mp_device = nullptr;
+}
@@ -0,0 +1,135 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/render/descriptor_allocator.h"
+#include "core/profiling/cpu_profiler.h"
+
+//@brief Hashes the fields that define a set layout (immutable samplers are not supported)
+static size_t HashLayout(std::span<const vk::DescriptorSetLayoutBinding> bindings, vk::DescriptorSetLayoutCreateFlags flags)
+{
+    size_t hash = std::hash<uint32_t>()(static_cast<uint32_t>(flags));
+    auto combine = [&hash](uint64_t value) {
+        hash ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+
+    for (const vk::DescriptorSetLayoutBinding& binding : bindings)
+    {
+        combine((static_cast<uint64_t>(binding.binding) << 32) | static_cast<uint32_t>(binding.descriptorType));
+        combine((static_cast<uint64_t>(binding.descriptorCount) << 32) | static_cast<uint32_t>(binding.stageFlags));
+    }
+
+    return hash;
+}
+
+static bool SameBindings(std::span<const vk::DescriptorSetLayoutBinding> a, std::span<const vk::DescriptorSetLayoutBinding> b)
+{
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const vk::DescriptorSetLayoutBinding& x, const vk::DescriptorSetLayoutBinding& y) {
+        return x.binding == y.binding && x.descriptorType == y.descriptorType &&
+            x.descriptorCount == y.descriptorCount && x.stageFlags == y.stageFlags;
+    });
+}
+
+vk::raii::DescriptorPool DescriptorAllocator::createPool()
+{
+    std::vector<vk::DescriptorPoolSize> poolSizes;
+    poolSizes.reserve(m_ratios.size());
+    for (const DescriptorPoolRatio& ratio : m_ratios)
+        poolSizes.push_back(vk::DescriptorPoolSize(ratio.type, std::max(1u, static_cast<uint32_t>(ratio.perSet * m_setsPerPool))));
+
+    // No eFreeDescriptorSet: sets are only ever released by resetting the whole pool
+    return vk::raii::DescriptorPool(*mp_device, vk::DescriptorPoolCreateInfo{
+        .maxSets = m_setsPerPool,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data()
+    });
+}
+
+void DescriptorAllocator::init(vk::raii::Device& device, uint32_t setsPerPool, std::span<const DescriptorPoolRatio> ratios)
+{
+    mp_device = &device;
+    m_setsPerPool = setsPerPool;
+    m_ratios.assign(ratios.begin(), ratios.end());
+
+    for (FramePools& frame : m_frames)
+    {
+        frame.pools.clear();
+        frame.pools.push_back(createPool());
+        frame.current = 0;
+    }
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frameIndex)
+{
+    m_frameIndex = frameIndex;
+    FramePools& frame = m_frames[frameIndex];
+
+    // Pools past current were never touched this cycle
+    for (size_t i = 0; i <= frame.current && i < frame.pools.size(); i++)
+        frame.pools[i].reset();
+    frame.current = 0;
+}
+
+vk::DescriptorSet DescriptorAllocator::allocate(vk::DescriptorSetLayout layout)
+{
+    FramePools& frame = m_frames[m_frameIndex];
+    vk::DescriptorSetAllocateInfo allocInfo{
+        .descriptorSetCount = 1,
+        .pSetLayouts = &layout
+    };
+
+    vk::DescriptorSet set;
+    while (true)
+    {
+        allocInfo.descriptorPool = *frame.pools[frame.current];
+        // Pointer overload reports exhaustion as a result instead of throwing
+        vk::Result result = (**mp_device).allocateDescriptorSets(&allocInfo, &set);
+
+        if (result == vk::Result::eSuccess)
+            return set;
+
+        if (result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool)
+            throw std::runtime_error("<DescriptorAllocator> failed to allocate descriptor set: " + vk::to_string(result));
+
+        // Chain the next pool, creating one the first time this frame needs it
+        if (++frame.current == frame.pools.size())
+        {
+            PROFILE_ZONE("DescriptorAllocator::grow");
+            frame.pools.push_back(createPool());
+            if constexpr (DISPLAY_VULKAN_INFO)
+                std::cout << "<DescriptorAllocator> frame " << m_frameIndex << " grew to " << frame.pools.size() << " pools" << std::endl;
+        }
+    }
+}
+
+vk::DescriptorSetLayout DescriptorAllocator::getLayout(
+    std::span<const vk::DescriptorSetLayoutBinding> bindings,
+    vk::DescriptorSetLayoutCreateFlags flags)
+{
+    std::vector<CachedLayout>& bucket = m_layoutCache[HashLayout(bindings, flags)];
+    for (const CachedLayout& cached : bucket)
+        if (cached.flags == flags && SameBindings(cached.bindings, bindings))
+            return *cached.layout;
+
+    CachedLayout& cached = bucket.emplace_back(CachedLayout{
+        .bindings = std::vector<vk::DescriptorSetLayoutBinding>(bindings.begin(), bindings.end()),
+        .flags = flags
+    });
+    cached.layout = vk::raii::DescriptorSetLayout(*mp_device, vk::DescriptorSetLayoutCreateInfo{
+        .flags = flags,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    });
+
+    return *cached.layout;
+}
+
+void DescriptorAllocator::clean()
+{
+    for (FramePools& frame : m_frames)
+    {
+        frame.pools.clear();
+        frame.current = 0;
+    }
+
+    m_layoutCache.clear();
+    mp_device = nullptr;
+}
@@ -0,0 +1,110 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/render/draw_batcher.h"
+#include "core/profiling/cpu_profiler.h"
+#include "core/profiling/render_counters.h"
+
+constexpr VkBufferUsageFlags INSTANCE_BUFFER_USAGE = VkBufferUsageFlagBits::VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+void DrawBatcher::init(vk::raii::Device& device, uint32_t initialCapacity)
+{
+    mp_device = &device;
+    for (MappedBuffer& buffer : m_instanceBuffers)
+        buffer.reserve(device, static_cast<vk::DeviceSize>(initialCapacity) * sizeof(InstanceData), INSTANCE_BUFFER_USAGE);
+
+    m_entries.reserve(initialCapacity);
+}
+
+void DrawBatcher::beginFrame(uint32_t frameIndex, LinearArena& arena)
+{
+    m_frameIndex = frameIndex;
+    // Sized from last frame so growth doesn't leave dead copies in the arena
+    size_t requestCount = m_requests.size();
+    size_t instanceCount = m_instances.size();
+    size_t slotCount = m_objectSlots.size();
+
+    RebindFrameVector(m_requests, &arena);
+    RebindFrameVector(m_instances, &arena);
+    RebindFrameVector(m_objectSlots, &arena);
+    m_requests.reserve(requestCount);
+    m_instances.reserve(instanceCount);
+    m_objectSlots.reserve(slotCount);
+}
+
+void DrawBatcher::flush(vk::raii::CommandBuffer& cmd, RenderQueue& queue)
+{
+    PROFILE_ZONE("DrawBatcher::flush");
+    m_drawCount = 0;
+    m_instanceCount = static_cast<uint32_t>(m_requests.size());
+
+    if (m_requests.empty())
+        return;
+
+    // Group by pipeline, then mesh. The radix sort is stable, so instances keep submission order.
+    m_entries.resize(m_requests.size());
+    for (uint32_t i = 0; i < m_instanceCount; i++)
+        m_entries[i] = SortEntry{ (static_cast<uint64_t>(m_requests[i].pipeline) << 32) | m_requests[i].mesh->getId(), i };
+    RadixSort(m_entries, m_scratch);
+
+    // Both streams share binding 1 bound at offset 0. Slot instance k sits at byte
+    // instanceBytes + 4k, which is instance index instanceBytes / 4 + k with a 4 byte stride.
+    vk::DeviceSize instanceBytes = m_instances.size() * sizeof(InstanceData);
+    vk::DeviceSize slotBytes = m_objectSlots.size() * sizeof(uint32_t);
+    MappedBuffer& instanceBuffer = m_instanceBuffers[m_frameIndex];
+    instanceBuffer.reserve(*mp_device, instanceBytes + slotBytes, INSTANCE_BUFFER_USAGE);
+
+    InstanceData* instances = reinterpret_cast<InstanceData*>(instanceBuffer.getData());
+    uint32_t* objectSlots = reinterpret_cast<uint32_t*>(instanceBuffer.getData() + instanceBytes);
+    uint32_t slotBase = static_cast<uint32_t>(instanceBytes / sizeof(uint32_t));
+    uint32_t instanceCursor = 0, slotCursor = 0;
+
+    uint32_t first = 0;
+    while (first < m_instanceCount)
+    {
+        uint32_t last = first + 1;
+        while (last < m_instanceCount && m_entries[last].key == m_entries[first].key)
+            last++;
+
+        const DrawRequest& request = m_requests[m_entries[first].index];
+        uint32_t firstInstance = 0;
+
+        if (request.pipeline == PType::Scene)
+        {
+            firstInstance = slotBase + slotCursor;
+            for (uint32_t i = first; i < last; i++)
+                objectSlots[slotCursor++] = m_objectSlots[m_requests[m_entries[i].index].payload];
+        }
+        else
+        {
+            firstInstance = instanceCursor;
+            for (uint32_t i = first; i < last; i++)
+                instances[instanceCursor++] = m_instances[m_requests[m_entries[i].index].payload];
+        }
+
+        queue.push(RenderPacket{
+            .key = SortKey::Make(0, request.pipeline, 0, request.mesh->getId()),
+            .mesh = request.mesh,
+            .pipeline = request.pipeline,
+            .instanceCount = last - first,
+            .firstInstance = firstInstance
+        });
+        m_drawCount++;
+        first = last;
+    }
+
+    instanceBuffer.flush(instanceBytes + slotBytes);
+    RenderCounters::Add(RenderCounters::Counter::UploadBytes, instanceBytes + slotBytes);
+    cmd.bindVertexBuffers(1, vk::Buffer(instanceBuffer.getBuffer()), vk::DeviceSize(0));
+}
+
+void DrawBatcher::destroy()
+{
+    for (MappedBuffer& buffer : m_instanceBuffers)
+        buffer.destroy();
+
+    // The arenas may be destroyed before the batcher
+    RebindFrameVector(m_requests, std::pmr::get_default_resource());
+    RebindFrameVector(m_instances, std::pmr::get_default_resource());
+    RebindFrameVector(m_objectSlots, std::pmr::get_default_resource());
+    mp_device = nullptr;
+}
@@ -0,0 +1,91 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/render/frame_scheduler.h"
+#include "core/profiling/cpu_profiler.h"
+
+void FrameScheduler::init(vk::raii::Device& device, uint32_t framesInFlight)
+{
+    if (framesInFlight == 0 || framesInFlight > MAX_FRAMES_IN_FLIGHT)
+        throw std::runtime_error("<FrameScheduler> frames in flight must be between 1 and " + std::to_string(MAX_FRAMES_IN_FLIGHT));
+
+    mp_device = &device;
+    m_framesInFlight = framesInFlight;
+    m_frameNumber = 0;
+    m_completedValue = 0;
+    m_frameIndex = 0;
+
+    vk::SemaphoreTypeCreateInfo typeInfo{
+        .semaphoreType = vk::SemaphoreType::eTimeline,
+        .initialValue = 0
+    };
+    m_timeline = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{ .pNext = &typeInfo });
+}
+
+uint32_t FrameScheduler::beginFrame()
+{
+    m_frameNumber++;
+    m_frameIndex = static_cast<uint32_t>(m_frameNumber % m_framesInFlight);
+
+    // The slot was last used framesInFlight frames ago
+    if (m_frameNumber > m_framesInFlight)
+        wait(m_frameNumber - m_framesInFlight);
+    return m_frameIndex;
+}
+
+void FrameScheduler::cancelFrame()
+{
+    m_frameNumber--;
+}
+
+vk::SemaphoreSubmitInfo FrameScheduler::getSignalInfo() const
+{
+    return vk::SemaphoreSubmitInfo{
+        .semaphore = *m_timeline,
+        .value = m_frameNumber,
+        .stageMask = vk::PipelineStageFlagBits2::eAllCommands
+    };
+}
+
+vk::SemaphoreSubmitInfo FrameScheduler::getWaitInfo(uint64_t frame, vk::PipelineStageFlags2 stage) const
+{
+    return vk::SemaphoreSubmitInfo{
+        .semaphore = *m_timeline,
+        .value = frame,
+        .stageMask = stage
+    };
+}
+
+uint64_t FrameScheduler::getCompletedValue()
+{
+    if (m_completedValue < m_frameNumber)
+        m_completedValue = m_timeline.getCounterValue();
+    return m_completedValue;
+}
+
+bool FrameScheduler::isComplete(uint64_t frame)
+{
+    return frame <= m_completedValue || frame <= getCompletedValue();
+}
+
+void FrameScheduler::wait(uint64_t frame)
+{
+    if (frame <= m_completedValue)
+        return;
+
+    PROFILE_ZONE("FrameScheduler::wait");
+    vk::SemaphoreWaitInfo waitInfo{
+        .semaphoreCount = 1,
+        .pSemaphores = &*m_timeline,
+        .pValues = &frame
+    };
+    // Blocks in the driver rather than polling on timeouts
+    if (mp_device->waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+        throw std::runtime_error("<FrameScheduler> timed out waiting for frame " + std::to_string(frame));
+    m_completedValue = frame;
+}
+
+void FrameScheduler::clean()
+{
+    m_timeline = nullptr;
+    mp_device = nullptr;
+}
@@ -0,0 +1,310 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/render/render_queue.h"
+#include "core/profiling/cpu_profiler.h"
+#include "core/profiling/render_counters.h"
+
+#include <array>
+#include <barrier>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+constexpr uint32_t RADIX_BUCKETS = 256;
+constexpr uint32_t RADIX_DIGIT_BITS = 8;
+constexpr uint32_t RADIX_MAX_THREADS = 8;
+
+namespace
+{
+    //@brief Shared state of one RadixSort call; thread t owns chunk t of every pass
+    struct RadixState
+    {
+        SortEntry* src;
+        SortEntry* dst;
+        size_t count;
+        size_t chunkSize;
+        uint32_t threadCount;
+        uint32_t shift = 0;
+        bool skip = false;
+        std::array<std::array<size_t, RADIX_BUCKETS>, RADIX_MAX_THREADS> buckets;
+
+        size_t chunkBegin(uint32_t t) const
+        { return std::min(count, chunkSize * t); }
+
+        size_t chunkEnd(uint32_t t) const
+        { return std::min(count, chunkSize * (t + 1)); }
+    };
+
+    //@brief Counts chunk t's digits of the current pass
+    void Histogram(RadixState& state, uint32_t t)
+    {
+        std::array<size_t, RADIX_BUCKETS>& counts = state.buckets[t];
+        counts.fill(0);
+        for (size_t i = state.chunkBegin(t); i < state.chunkEnd(t); i++)
+            counts[(state.src[i].key >> state.shift) & (RADIX_BUCKETS - 1)]++;
+    }
+
+    //@brief Turns per-chunk counts into scatter offsets; flags the pass as skippable when one digit holds every key
+    void Prefix(RadixState& state)
+    {
+        size_t offset = 0;
+        state.skip = false;
+        for (uint32_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            size_t bucketStart = offset;
+            for (uint32_t t = 0; t < state.threadCount; t++)
+            {
+                size_t chunkCount = state.buckets[t][b];
+                state.buckets[t][b] = offset;
+                offset += chunkCount;
+            }
+
+            if (offset - bucketStart == state.count)
+                state.skip = true;
+        }
+    }
+
+    //@brief Moves chunk t's entries to their sorted position for the current digit
+    void Scatter(RadixState& state, uint32_t t)
+    {
+        std::array<size_t, RADIX_BUCKETS>& offsets = state.buckets[t];
+        for (size_t i = state.chunkBegin(t); i < state.chunkEnd(t); i++)
+            state.dst[offsets[(state.src[i].key >> state.shift) & (RADIX_BUCKETS - 1)]++] = state.src[i];
+    }
+
+    //@brief Moves to the next digit (the destination becomes the source unless the pass was skipped)
+    void Advance(RadixState& state)
+    {
+        if (!state.skip)
+            std::swap(state.src, state.dst);
+        state.shift += RADIX_DIGIT_BITS;
+    }
+
+    //@brief Threads kept alive across RadixSort calls, so large sorts don't create threads every frame
+    class RadixWorkers
+    {
+    private:
+        std::vector<std::jthread> m_threads;
+        std::mutex m_runMutex;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        void (*mp_job)(void*, uint32_t) = nullptr;
+        void* mp_context = nullptr;
+        uint64_t m_generation = 0;
+        uint32_t m_participants = 0;
+        uint32_t m_pending = 0;
+        bool m_stop = false;
+
+        //@brief Runs worker t's share of every job published after generation
+        void workerLoop(uint32_t t, uint64_t generation)
+        {
+            std::unique_lock lock(m_mutex);
+            while (true)
+            {
+                m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+                if (m_stop)
+                    return;
+                generation = m_generation;
+                if (t >= m_participants)
+                    continue;
+
+                lock.unlock();
+                mp_job(mp_context, t);
+                lock.lock();
+                if (--m_pending == 0)
+                    m_done.notify_one();
+            }
+        }
+
+    public:
+        ~RadixWorkers()
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            // Joins before the condition variables go away
+            m_threads.clear();
+        }
+
+        //@brief Calls job(t) for t in [0, threadCount), t = 0 on the calling thread, and waits for all of them
+        template<typename Fn>
+        void run(uint32_t threadCount, Fn& job)
+        {
+            std::lock_guard runLock(m_runMutex);
+            while (m_threads.size() + 1 < threadCount)
+            {
+                uint32_t t = static_cast<uint32_t>(m_threads.size()) + 1;
+                m_threads.emplace_back([this, t, generation = m_generation] { workerLoop(t, generation); });
+            }
+
+            {
+                std::lock_guard lock(m_mutex);
+                mp_job = [](void* context, uint32_t t) { (*static_cast<Fn*>(context))(t); };
+                mp_context = &job;
+                m_participants = threadCount;
+                m_pending = threadCount - 1;
+                m_generation++;
+            }
+            m_wake.notify_all();
+
+            job(0);
+            std::unique_lock lock(m_mutex);
+            m_done.wait(lock, [&] { return m_pending == 0; });
+        }
+    };
+
+    RadixWorkers& Workers()
+    {
+        static RadixWorkers workers;
+        return workers;
+    }
+}
+
+void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+{
+    PROFILE_ZONE("RadixSort");
+    if (entries.size() < 2)
+        return;
+
+    scratch.resize(entries.size());
+
+    RadixState state{
+        .src = entries.data(),
+        .dst = scratch.data(),
+        .count = entries.size(),
+        .chunkSize = entries.size(),
+        .threadCount = 1
+    };
+
+    if (state.count >= RADIX_PARALLEL_THRESHOLD)
+    {
+        state.threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, RADIX_MAX_THREADS);
+        state.chunkSize = (state.count + state.threadCount - 1) / state.threadCount;
+    }
+
+    if (state.threadCount == 1)
+    {
+        // Digit counts do not depend on order, so one read yields the histogram of every pass
+        std::array<std::array<size_t, RADIX_BUCKETS>, 64 / RADIX_DIGIT_BITS> digitCounts{};
+        for (size_t i = 0; i < state.count; i++)
+            for (uint32_t d = 0; d < digitCounts.size(); d++)
+                digitCounts[d][(state.src[i].key >> (d * RADIX_DIGIT_BITS)) & (RADIX_BUCKETS - 1)]++;
+
+        while (state.shift < 64)
+        {
+            state.buckets[0] = digitCounts[state.shift / RADIX_DIGIT_BITS];
+            Prefix(state);
+            if (!state.skip)
+                Scatter(state, 0);
+            Advance(state);
+        }
+    }
+    else
+    {
+        // Two sync points per digit: after the histograms (prefix sums) and after the scatter (advance)
+        bool scattered = false;
+        auto onPhaseEnd = [&]() noexcept {
+            if (scattered)
+                Advance(state);
+            else
+                Prefix(state);
+            scattered = !scattered;
+        };
+        std::barrier sync(state.threadCount, onPhaseEnd);
+
+        auto worker = [&](uint32_t t) {
+            while (state.shift < 64)
+            {
+                Histogram(state, t);
+                sync.arrive_and_wait();
+                if (!state.skip)
+                    Scatter(state, t);
+                sync.arrive_and_wait();
+            }
+        };
+
+        Workers().run(state.threadCount, worker);
+    }
+
+    if (state.src != entries.data())
+        entries.swap(scratch);
+}
+
+void RenderQueue::reserve(size_t packetCount)
+{
+    m_packets.reserve(packetCount);
+    m_entries.reserve(packetCount);
+    m_scratch.reserve(packetCount);
+}
+
+void RenderQueue::sort()
+{
+    PROFILE_ZONE("RenderQueue::sort");
+    m_entries.resize(m_packets.size());
+    for (size_t i = 0; i < m_packets.size(); i++)
+        m_entries[i] = SortEntry{ m_packets[i].key, static_cast<uint32_t>(i) };
+
+    RadixSort(m_entries, m_scratch);
+    m_sorted = true;
+}
+
+void RenderQueue::record(
+    vk::raii::CommandBuffer& cmd,
+    const vk::raii::PipelineLayout& layout,
+    std::span<const vk::Pipeline> pipelines)
+{
+    PROFILE_ZONE("RenderQueue::record");
+    if (!m_sorted)
+        sort();
+
+    m_stats = {};
+    uint64_t instances = 0;
+    PType boundPipeline = PTypeCount;
+    Mesh* boundMesh = nullptr;
+    vk::DescriptorSet boundSet = VK_NULL_HANDLE;
+    uint32_t boundOffset = 0;
+
+    for (const SortEntry& entry : m_entries)
+    {
+        const RenderPacket& packet = m_packets[entry.index];
+
+        if (packet.pipeline != boundPipeline)
+        {
+            boundPipeline = packet.pipeline;
+            cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipelines[boundPipeline]);
+            m_stats.pipelineBinds++;
+        }
+
+        if (packet.mesh != boundMesh)
+        {
+            boundMesh = packet.mesh;
+            boundMesh->bind(cmd);
+            m_stats.meshBinds++;
+        }
+
+        // Sets stay bound across pipeline changes because every pipeline shares the layout
+        if (packet.descriptorSet && (packet.descriptorSet != boundSet || packet.dynamicOffset != boundOffset))
+        {
+            boundSet = packet.descriptorSet;
+            boundOffset = packet.dynamicOffset;
+            cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *layout, 0, boundSet, boundOffset);
+            m_stats.descriptorBinds++;
+        }
+
+        packet.mesh->draw(cmd, packet.instanceCount, packet.firstInstance);
+        m_stats.draws++;
+        m_stats.triangles += static_cast<uint64_t>(packet.mesh->getIndexCount() / 3) * packet.instanceCount;
+        instances += packet.instanceCount;
+    }
+
+    // Totals go to the counter registry once per record rather than per draw
+    RenderCounters::Add(RenderCounters::Counter::Draws, m_stats.draws);
+    RenderCounters::Add(RenderCounters::Counter::Instances, instances);
+    RenderCounters::Add(RenderCounters::Counter::Triangles, m_stats.triangles);
+    RenderCounters::Add(RenderCounters::Counter::PipelineBinds, m_stats.pipelineBinds);
+    RenderCounters::Add(RenderCounters::Counter::DescriptorBinds, m_stats.descriptorBinds);
+    RenderCounters::Add(RenderCounters::Counter::MeshBinds, m_stats.meshBinds);
+}
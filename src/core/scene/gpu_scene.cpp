@@ -0,0 +1,198 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/scene/gpu_scene.h"
+#include "core/profiling/cpu_profiler.h"
+#include "core/profiling/render_counters.h"
+
+// Threads per scatter workgroup (numthreads in scene_scatter.slang)
+constexpr uint32_t SCATTER_GROUP_SIZE = 64;
+
+static_assert(sizeof(ObjectRecord) == 96, "ObjectRecord must match OBJECT_RECORD_SIZE in the shaders");
+static_assert(sizeof(ObjectUpdate) == 112, "ObjectUpdate must match OBJECT_UPDATE_SIZE in scene_scatter.slang");
+
+void GpuScene::init(vk::raii::Device& device, BindlessRegistry& bindless, vk::ShaderModule scatterShader, uint32_t capacity)
+{
+    mp_device = &device;
+    mp_bindless = &bindless;
+    m_capacity = capacity;
+    m_objectCount = 0;
+
+    m_records.resize(capacity);
+    m_dirtyFlags.assign(capacity, 0);
+    m_freeSlots.clear();
+    m_freeSlots.reserve(capacity);
+    // Hand out low slots first
+    for (uint32_t slot = capacity; slot > 0; slot--)
+        m_freeSlots.push_back(slot - 1);
+
+    m_sceneAllocation = Buffer::Create(
+        device,
+        m_sceneBuffer,
+        static_cast<vk::DeviceSize>(capacity) * sizeof(ObjectRecord),
+        VkBufferUsageFlagBits::VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        0,
+        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        MeshMemory);
+    m_sceneSlot = bindless.registerStorageBuffer(m_sceneBuffer);
+    m_uploadSlots.fill(BINDLESS_INVALID_INDEX);
+
+    // Set 0 is unused; the scatter pass only reads the bindless set
+    m_emptyLayout = vk::raii::DescriptorSetLayout(device, vk::DescriptorSetLayoutCreateInfo{});
+    vk::DescriptorSetLayout setLayouts[] = { *m_emptyLayout, *bindless.getLayout() };
+    vk::PushConstantRange pcRange{
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .offset = 0,
+        .size = sizeof(ScatterConstants)
+    };
+
+    m_layout = vk::raii::PipelineLayout(device, vk::PipelineLayoutCreateInfo{
+        .setLayoutCount = 2,
+        .pSetLayouts = setLayouts,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pcRange
+    });
+
+    m_scatterPipeline = vk::raii::Pipeline(device, nullptr, vk::ComputePipelineCreateInfo{
+        .stage = { .stage = vk::ShaderStageFlagBits::eCompute, .module = scatterShader, .pName = "scatterMain" },
+        .layout = m_layout
+    });
+}
+
+void GpuScene::markDirty(ObjectHandle slot)
+{
+    if (!m_dirtyFlags[slot])
+    {
+        m_dirtyFlags[slot] = 1;
+        m_dirty.push_back(slot);
+    }
+}
+
+ObjectHandle GpuScene::add(const ObjectRecord& record)
+{
+    if (m_freeSlots.empty())
+        throw std::runtime_error("<GpuScene> scene buffer is full");
+
+    ObjectHandle slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    m_records[slot] = record;
+    m_objectCount++;
+    markDirty(slot);
+    return slot;
+}
+
+void GpuScene::update(ObjectHandle handle, const ObjectRecord& record)
+{
+    m_records[handle] = record;
+    markDirty(handle);
+}
+
+void GpuScene::setTransform(ObjectHandle handle, const glm::mat4& transform)
+{
+    m_records[handle].transform = transform;
+    markDirty(handle);
+}
+
+void GpuScene::replaceMaterial(uint32_t from, uint32_t to)
+{
+    for (ObjectHandle slot = 0; slot < m_records.size(); slot++)
+    {
+        if (m_records[slot].material == from)
+        {
+            m_records[slot].material = to;
+            markDirty(slot);
+        }
+    }
+}
+
+void GpuScene::remove(ObjectHandle handle)
+{
+    // The stale record stays in place; nothing references a free slot
+    m_freeSlots.push_back(handle);
+    m_objectCount--;
+}
+
+void GpuScene::upload(vk::raii::CommandBuffer& cmd, uint32_t frameIndex)
+{
+    PROFILE_ZONE("GpuScene::upload");
+    m_uploadedBytes = 0;
+    if (m_dirty.empty())
+        return;
+
+    uint32_t updateCount = static_cast<uint32_t>(m_dirty.size());
+    vk::DeviceSize updateBytes = static_cast<vk::DeviceSize>(updateCount) * sizeof(ObjectUpdate);
+
+    MappedBuffer& uploadBuffer = m_uploadBuffers[frameIndex];
+    if (uploadBuffer.reserve(*mp_device, updateBytes, VkBufferUsageFlagBits::VK_BUFFER_USAGE_STORAGE_BUFFER_BIT))
+    {
+        // The previous buffer of this frame slot is no longer in use, so its slot can be rewritten
+        if (m_uploadSlots[frameIndex] != BINDLESS_INVALID_INDEX)
+            mp_bindless->releaseStorageBuffer(m_uploadSlots[frameIndex]);
+        m_uploadSlots[frameIndex] = mp_bindless->registerStorageBuffer(uploadBuffer.getBuffer());
+    }
+
+    ObjectUpdate* updates = reinterpret_cast<ObjectUpdate*>(uploadBuffer.getData());
+    for (uint32_t i = 0; i < updateCount; i++)
+    {
+        ObjectHandle slot = m_dirty[i];
+        updates[i] = ObjectUpdate{ .slot = slot, .pad = { 0, 0, 0 }, .record = m_records[slot] };
+        m_dirtyFlags[slot] = 0;
+    }
+    m_dirty.clear();
+    uploadBuffer.flush(updateBytes);
+
+    // Earlier frames' vertex reads must finish before records are overwritten
+    vk::MemoryBarrier2 readBeforeWrite{
+        .srcStageMask = vk::PipelineStageFlagBits2::eVertexShader,
+        .srcAccessMask = {},
+        .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderStorageWrite
+    };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &readBeforeWrite });
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *m_scatterPipeline);
+    mp_bindless->bind(cmd, m_layout, vk::PipelineBindPoint::eCompute);
+    cmd.pushConstants<ScatterConstants>(m_layout, vk::ShaderStageFlagBits::eCompute, 0, ScatterConstants{
+        .sceneBuffer = m_sceneSlot,
+        .updateBuffer = m_uploadSlots[frameIndex],
+        .updateCount = updateCount,
+        .pad = 0
+    });
+    cmd.dispatch((updateCount + SCATTER_GROUP_SIZE - 1) / SCATTER_GROUP_SIZE, 1, 1);
+
+    vk::MemoryBarrier2 writeBeforeRead{
+        .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eVertexShader,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead
+    };
+    cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &writeBeforeRead });
+
+    m_uploadedBytes = updateBytes;
+    RenderCounters::Add(RenderCounters::Counter::Barriers, 2);
+    RenderCounters::Add(RenderCounters::Counter::UploadBytes, updateBytes);
+}
+
+void GpuScene::clean()
+{
+    for (MappedBuffer& buffer : m_uploadBuffers)
+        buffer.destroy();
+
+    if (m_sceneBuffer != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(Allocator::GetAllocator(), m_sceneBuffer, m_sceneAllocation);
+        m_sceneBuffer = VK_NULL_HANDLE;
+        m_sceneAllocation = VK_NULL_HANDLE;
+    }
+
+    m_scatterPipeline = nullptr;
+    m_layout = nullptr;
+    m_emptyLayout = nullptr;
+    m_records.clear();
+    m_freeSlots.clear();
+    m_dirty.clear();
+    m_dirtyFlags.clear();
+    m_objectCount = 0;
+    mp_device = nullptr;
+    mp_bindless = nullptr;
+}
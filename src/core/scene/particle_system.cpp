@@ -0,0 +1,77 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/scene/particle_system.h"
+#include "core/profiling/cpu_profiler.h"
+#include "core/profiling/render_counters.h"
+
+// Threads per simulation workgroup (numthreads in particles.slang)
+constexpr uint32_t PARTICLE_GROUP_SIZE = 256;
+
+static_assert(sizeof(Particle) == 32, "Particle must match PARTICLE_SIZE in particles.slang");
+
+void ParticleSystem::init(vk::raii::Device& device, BindlessRegistry& bindless, AsyncCompute& asyncCompute, vk::ShaderModule simulateShader, uint32_t count)
+{
+    mp_bindless = &bindless;
+    m_count = count;
+    m_time = 0.0f;
+    m_cleared = false;
+
+    m_allocation = Buffer::Create(
+        device,
+        m_buffer,
+        static_cast<vk::DeviceSize>(count) * sizeof(Particle),
+        VkBufferUsageFlagBits::VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        0,
+        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        MeshMemory);
+    m_bufferSlot = bindless.registerStorageBuffer(m_buffer);
+
+    m_pipeline = asyncCompute.createPipeline(simulateShader, "simulateMain", sizeof(SimulateConstants));
+}
+
+void ParticleSystem::record(AsyncCompute& asyncCompute, float deltaTime)
+{
+    PROFILE_ZONE("ParticleSystem::record");
+    vk::raii::CommandBuffer& cmd = asyncCompute.getCommandBuffer();
+    GPU_SCOPE(asyncCompute.getProfiler(), cmd, "Particles");
+
+    if (!m_cleared)
+    {
+        // Zero life respawns every particle on the first step
+        cmd.fillBuffer(m_buffer, 0, VK_WHOLE_SIZE, 0);
+        vk::MemoryBarrier2 clearBeforeSimulate{
+            .srcStageMask = vk::PipelineStageFlagBits2::eClear,
+            .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+            .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+            .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+        };
+        cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &clearBeforeSimulate });
+        RenderCounters::Add(RenderCounters::Counter::Barriers);
+        m_cleared = true;
+    }
+
+    m_time += deltaTime;
+    SimulateConstants constants{
+        .particleBuffer = m_bufferSlot,
+        .particleCount = m_count,
+        .deltaTime = deltaTime,
+        .time = m_time
+    };
+    asyncCompute.dispatch(m_pipeline, &constants, (m_count + PARTICLE_GROUP_SIZE - 1) / PARTICLE_GROUP_SIZE);
+}
+
+void ParticleSystem::clean()
+{
+    if (m_buffer != VK_NULL_HANDLE)
+    {
+        mp_bindless->releaseStorageBuffer(m_bufferSlot);
+        vmaDestroyBuffer(Allocator::GetAllocator(), m_buffer, m_allocation);
+        m_buffer = VK_NULL_HANDLE;
+        m_allocation = VK_NULL_HANDLE;
+    }
+
+    m_pipeline = ComputePipeline{};
+    m_count = 0;
+    mp_bindless = nullptr;
+}
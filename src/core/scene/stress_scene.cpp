@@ -0,0 +1,280 @@
+#include "core/core_pch.h"
+#include "core/engine.h"
+#include "core/scene/stress_scene.h"
+#include "core/profiling/cpu_profiler.h"
+
+#include <filesystem>
+#include <fstream>
+#include <glm/gtc/constants.hpp>
+
+constexpr uint32_t STRESS_TEXTURE_SIZE = 64;
+
+//@brief Builds a regular polygon as a triangle fan around its center
+static void MakePolygon(uint32_t sides, const glm::vec3& color, std::vector<Vertex>& vertices, std::vector<uint16_t>& indices)
+{
+    vertices.clear();
+    indices.clear();
+    vertices.emplace_back(glm::vec2(0.0f, 0.0f), color);
+
+    for (uint32_t i = 0; i < sides; i++)
+    {
+        float angle = glm::two_pi<float>() * static_cast<float>(i) / static_cast<float>(sides);
+        vertices.emplace_back(glm::vec2(std::cos(angle), std::sin(angle)), color * (0.5f + 0.5f * (i & 1)));
+        indices.insert(indices.end(), { 0, static_cast<uint16_t>(1 + i), static_cast<uint16_t>(1 + (i + 1) % sides) });
+    }
+}
+
+//@brief Builds an object's model matrix
+static glm::mat4 ModelMatrix(const glm::vec3& position, float rotation, float scale)
+{
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+    model = glm::rotate(model, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+    return glm::scale(model, glm::vec3(scale));
+}
+
+//@brief Gets the NDC depth of position remapped from [-1, 1] to the sort key's [0, 1]
+//@brief (points behind the camera sort first)
+static float ViewDepth(const glm::mat4& viewProj, const glm::vec3& position)
+{
+    glm::vec4 clip = viewProj * glm::vec4(position, 1.0f);
+    return clip.w > 0.0f ? clip.z / clip.w * 0.5f + 0.5f : 0.0f;
+}
+
+void StressScene::spawn(Object& object)
+{
+    std::uniform_real_distribution<float> pos(-1.5f, 1.5f), unit(0.0f, 1.0f);
+
+    object.position = glm::vec3(pos(m_rng), pos(m_rng), 0.0f);
+    object.scale = 0.005f + 0.03f * unit(m_rng);
+    object.rotation = glm::two_pi<float>() * unit(m_rng);
+    object.spin = unit(m_rng) < m_config.animated ? glm::radians(180.0f) * (unit(m_rng) - 0.5f) : 0.0f;
+    object.color = glm::vec4(glm::vec3(0.5f + 0.5f * unit(m_rng)), 1.0f);
+    object.geometry = m_rng() % m_meshes.size();
+    object.texture = m_textures.empty() ? 0 : m_rng() % m_textures.size();
+}
+
+void StressScene::init(vk::raii::Device& device, const StressSceneConfig& config)
+{
+    PROFILE_ZONE("StressScene::init");
+    m_config = config;
+    m_config.geometryCount = std::max(1u, m_config.geometryCount);
+    m_config.churn = std::clamp(m_config.churn, 0.0f, 1.0f);
+    m_config.animated = std::clamp(m_config.animated, 0.0f, 1.0f);
+    m_config.instanced |= m_config.gpuScene;
+    m_rng.seed(m_config.seed);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint16_t> indices;
+    m_meshes.resize(m_config.geometryCount);
+    for (uint32_t i = 0; i < m_config.geometryCount; i++)
+    {
+        glm::vec3 color(((i * 37) % 255) / 255.0f, ((i * 91) % 255) / 255.0f, ((i * 173) % 255) / 255.0f);
+        MakePolygon(3 + (i * 5) % 61, color, vertices, indices);
+        m_meshes[i].init(device, &vertices, &indices);
+    }
+
+    std::vector<uint32_t> pixels(STRESS_TEXTURE_SIZE * STRESS_TEXTURE_SIZE);
+    m_textures.resize(m_config.textureCount);
+    for (uint32_t i = 0; i < m_config.textureCount; i++)
+    {
+        uint32_t tint = 0xFF000000u | (m_rng() & 0x00FFFFFFu);
+        for (uint32_t y = 0; y < STRESS_TEXTURE_SIZE; y++)
+            for (uint32_t x = 0; x < STRESS_TEXTURE_SIZE; x++)
+                pixels[y * STRESS_TEXTURE_SIZE + x] = ((x / 8 + y / 8) & 1) ? tint : 0xFFFFFFFFu;
+        m_textures[i].initBuffer(device, STRESS_TEXTURE_SIZE, STRESS_TEXTURE_SIZE, pixels.data());
+        Core::GetInstance().getBindlessRegistry().registerTexture(m_textures[i]);
+    }
+
+    m_objects.resize(m_config.objectCount);
+    for (Object& object : m_objects)
+        spawn(object);
+
+    m_uniformStride = 0;
+    if (m_config.persistentUniforms && !m_config.instanced && !m_objects.empty())
+    {
+        Core& core = Core::GetInstance();
+        vk::DeviceSize alignment = core.getPhysicalDevice().getProperties().limits.minUniformBufferOffsetAlignment;
+        m_uniformStride = (sizeof(ObjectUniforms) + alignment - 1) & ~(alignment - 1);
+        m_uniforms.initBuffer(
+            device,
+            m_uniformStride * m_objects.size(),
+            VkBufferUsageFlagBits::VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            core.getConfig().framesInFlight,
+            alignment);
+        for (uint32_t i = 0; i < m_objects.size(); i++)
+            writeUniforms(i);
+    }
+
+    if (m_config.gpuScene)
+    {
+        GpuScene& scene = Core::GetInstance().getGpuScene();
+        for (Object& object : m_objects)
+            object.handle = scene.add(makeRecord(object));
+    }
+
+    m_active = true;
+}
+
+void StressScene::update(float dt)
+{
+    PROFILE_ZONE("StressScene::update");
+    GpuScene* scene = m_config.gpuScene ? &Core::GetInstance().getGpuScene() : nullptr;
+    for (uint32_t i = 0; i < m_objects.size(); i++)
+    {
+        Object& object = m_objects[i];
+        if (object.spin == 0.0f)
+            continue;
+
+        object.rotation += object.spin * dt;
+        if (scene)
+            scene->setTransform(object.handle, ModelMatrix(object.position, object.rotation, object.scale));
+        if (usesPersistentUniforms())
+            writeUniforms(i);
+    }
+
+    uint32_t churned = static_cast<uint32_t>(m_config.churn * static_cast<float>(m_objects.size()));
+    for (uint32_t i = 0; i < churned; i++)
+    {
+        uint32_t index = m_rng() % m_objects.size();
+        Object& object = m_objects[index];
+        spawn(object);
+        if (scene)
+            scene->update(object.handle, makeRecord(object));
+        if (usesPersistentUniforms())
+            writeUniforms(index);
+    }
+}
+
+void StressScene::writeUniforms(uint32_t index)
+{
+    const Object& object = m_objects[index];
+    ObjectUniforms uniforms{ .model = ModelMatrix(object.position, object.rotation, object.scale), .color = object.color };
+    m_uniforms.update(index * m_uniformStride, std::span<const ObjectUniforms>(&uniforms, 1));
+}
+
+void StressScene::flushUniforms(vk::raii::CommandBuffer& cmd, uint32_t frameIndex)
+{
+    if (!usesPersistentUniforms())
+        return;
+
+    m_uniforms.beginFrame(frameIndex);
+    m_uniforms.flush(cmd, vk::PipelineStageFlagBits2::eVertexShader, vk::AccessFlagBits2::eUniformRead);
+}
+
+ObjectRecord StressScene::makeRecord(const Object& object) const
+{
+    return ObjectRecord{
+        .transform = ModelMatrix(object.position, object.rotation, object.scale),
+        // Polygons are built on the unit circle
+        .bounds = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+        .material = m_textures.empty() ? 0 : m_textures[object.texture].getBindlessIndex(),
+        .mesh = m_meshes[object.geometry].getId()
+    };
+}
+
+void StressScene::submit(
+    RenderQueue& queue,
+    vk::DescriptorSet objectSet,
+    UniformRingBuffer& uniformRing,
+    const glm::mat4& viewProj)
+{
+    PROFILE_ZONE("StressScene::submit");
+    for (const Object& object : m_objects)
+    {
+        Mesh& mesh = m_meshes[object.geometry];
+        glm::mat4 model = ModelMatrix(object.position, object.rotation, object.scale);
+        queue.push(RenderPacket{
+            .key = SortKey::Make(0, PType::Standard, object.texture, mesh.getId(), ViewDepth(viewProj, object.position)),
+            .mesh = &mesh,
+            .pipeline = PType::Standard,
+            .descriptorSet = objectSet,
+            .dynamicOffset = uniformRing.push(ObjectUniforms{ .model = model, .color = object.color })
+        });
+    }
+}
+
+void StressScene::submit(RenderQueue& queue, vk::DescriptorSet uniformSet, const glm::mat4& viewProj)
+{
+    PROFILE_ZONE("StressScene::submitPersistent");
+    uint32_t frameOffset = static_cast<uint32_t>(m_uniforms.getOffset());
+    for (uint32_t i = 0; i < m_objects.size(); i++)
+    {
+        const Object& object = m_objects[i];
+        Mesh& mesh = m_meshes[object.geometry];
+        queue.push(RenderPacket{
+            .key = SortKey::Make(0, PType::Standard, object.texture, mesh.getId(), ViewDepth(viewProj, object.position)),
+            .mesh = &mesh,
+            .pipeline = PType::Standard,
+            .descriptorSet = uniformSet,
+            .dynamicOffset = frameOffset + static_cast<uint32_t>(i * m_uniformStride)
+        });
+    }
+}
+
+void StressScene::submit(DrawBatcher& batcher)
+{
+    PROFILE_ZONE("StressScene::submitInstanced");
+    if (m_config.gpuScene)
+    {
+        // Records are already resident; only the slot is streamed per instance
+        for (const Object& object : m_objects)
+            batcher.submit(m_meshes[object.geometry], object.handle);
+        return;
+    }
+
+    for (const Object& object : m_objects)
+    {
+        batcher.submit(m_meshes[object.geometry], PType::Instanced, InstanceData{
+            .transform = ModelMatrix(object.position, object.rotation, object.scale),
+            .color = object.color,
+            // Bindless texture slot (slot 0 is the engine's white texture)
+            .materialIndex = m_textures.empty() ? 0 : m_textures[object.texture].getBindlessIndex()
+        });
+    }
+}
+
+void StressScene::writeCsvRow(const StressSceneResult& result) const
+{
+    bool writeHeader = !std::filesystem::exists(m_config.csvPath) || std::filesystem::file_size(m_config.csvPath) == 0;
+    std::ofstream out(m_config.csvPath, std::ios::app);
+
+    if (!out.is_open())
+    {
+        std::cerr << "<StressScene> failed to open " << m_config.csvPath << std::endl;
+        return;
+    }
+
+    if (writeHeader)
+        out << "objects,geometries,textures,churn,instanced,gpu_scene,animated,frames,cpu_mean_ms,cpu_p50_ms,cpu_p95_ms,cpu_p99_ms,gpu_ms,draws,binds,upload_kb,gpu_memory_mb\n";
+
+    out << m_config.objectCount << ',' << m_config.geometryCount << ',' << m_config.textureCount << ','
+        << m_config.churn << ',' << m_config.instanced << ',' << m_config.gpuScene << ',' << m_config.animated << ',' << result.cpu.count << ','
+        << result.cpu.mean << ',' << result.cpu.p50 << ',' << result.cpu.p95 << ',' << result.cpu.p99 << ','
+        << result.gpuMs << ',' << result.drawCount << ',' << result.bindCount << ','
+        << static_cast<double>(result.uploadBytes) / 1024.0 << ','
+        << static_cast<double>(result.gpuMemoryBytes) / (1024.0 * 1024.0) << '\n';
+}
+
+void StressScene::destroy()
+{
+    if (m_config.gpuScene)
+    {
+        GpuScene& scene = Core::GetInstance().getGpuScene();
+        for (const Object& object : m_objects)
+            scene.remove(object.handle);
+    }
+
+    // Retired rather than destroyed so a scene can be unloaded while frames are still in flight
+    for (Mesh& mesh : m_meshes)
+        mesh.retire();
+    for (ImageBuffer& texture : m_textures)
+        texture.retire();
+    if (usesPersistentUniforms())
+        m_uniforms.retire();
+    m_uniformStride = 0;
+
+    m_meshes.clear();
+    m_textures.clear();
+    m_objects.clear();
+    m_active = false;
+}
@@ -0,0 +1,114 @@
+#include "core/core_pch.h"
+#include "core/system/frame_pacer.h"
+#include "core/profiling/cpu_profiler.h"
+
+#include <thread>
+
+void FramePacer::init(const PresentConfig& config, bool presentWait)
+{
+    if (config.policy == PresentPolicy::Capped && config.fpsCap <= 0.0)
+        throw std::runtime_error("<FramePacer> the Capped policy needs a positive fpsCap");
+
+    m_config = config;
+    m_presentWait = presentWait;
+    m_pendingBegin = 0;
+    m_pendingCount = 0;
+    m_nextFrame = Clock::now();
+    m_latency.clear();
+}
+
+void FramePacer::pace(vk::raii::SwapchainKHR& swapChain, bool focused)
+{
+    PROFILE_ZONE("FramePacer::pace");
+    if (m_presentWait)
+        collectPresents(swapChain, m_config.policy == PresentPolicy::LowLatency);
+
+    double fps = m_config.policy == PresentPolicy::Capped ? m_config.fpsCap : 0.0;
+    if (!focused && m_config.backgroundFps > 0.0)
+        fps = fps > 0.0 ? std::min(fps, m_config.backgroundFps) : m_config.backgroundFps;
+
+    if (fps > 0.0)
+        limit(fps);
+    else
+        m_nextFrame = Clock::now();
+}
+
+void FramePacer::limit(double fps)
+{
+    Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    Clock::time_point target = m_nextFrame;
+    Clock::time_point now = Clock::now();
+
+    if (now >= target)
+    {
+        // Slightly late frames keep the schedule, a hitch restarts it instead of bursting to catch up
+        m_nextFrame = (now - target < period ? target : now) + period;
+        return;
+    }
+
+    // Sleeps overshoot by up to the scheduler's granularity, so the tail is spun
+    if (target - now > PACER_SPIN_THRESHOLD)
+        std::this_thread::sleep_for(target - now - PACER_SPIN_THRESHOLD);
+    while (Clock::now() < target)
+        std::this_thread::yield();
+
+    m_nextFrame = target + period;
+}
+
+bool FramePacer::waitForPresent(vk::raii::SwapchainKHR& swapChain, const PendingPresent& present, uint64_t timeout)
+{
+    vk::Result result;
+    try
+    {
+        result = swapChain.waitForPresent(present.presentId, timeout);
+    }
+    catch (const vk::SystemError&)
+    {
+        // Out of date or surface lost, the swap chain is about to be recreated
+        m_pendingCount = 0;
+        return false;
+    }
+    if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
+        return false;
+
+    m_lastLatencyMs = std::chrono::duration<double, std::milli>(Clock::now() - present.inputTime).count();
+    m_latency.record(m_lastLatencyMs);
+    return true;
+}
+
+void FramePacer::collectPresents(vk::raii::SwapchainKHR& swapChain, bool block)
+{
+    if (m_pendingCount == 0)
+        return;
+
+    if (block)
+    {
+        // Presents complete in order, so once the newest completes every older one has too (their
+        // completion times are unknown, so only the newest's latency is recorded)
+        const PendingPresent& newest = m_pending[(m_pendingBegin + m_pendingCount - 1) % PACER_MAX_PENDING];
+        if (waitForPresent(swapChain, newest, PACER_PRESENT_TIMEOUT_NS))
+            m_pendingCount = 0;
+        return;
+    }
+
+    while (m_pendingCount > 0 && waitForPresent(swapChain, m_pending[m_pendingBegin], 0))
+    {
+        m_pendingBegin = (m_pendingBegin + 1) % PACER_MAX_PENDING;
+        m_pendingCount--;
+    }
+}
+
+void FramePacer::onPresent(uint64_t presentId)
+{
+    if (!m_presentWait)
+        return;
+
+    // Drops the oldest when presents outrun the display (e.g. mailbox replacing queued images)
+    if (m_pendingCount == PACER_MAX_PENDING)
+    {
+        m_pendingBegin = (m_pendingBegin + 1) % PACER_MAX_PENDING;
+        m_pendingCount--;
+    }
+    m_pending[(m_pendingBegin + m_pendingCount) % PACER_MAX_PENDING] = { .presentId = presentId, .inputTime = m_inputTime };
+    m_pendingCount++;
+}
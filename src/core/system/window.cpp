@@ -74,3 +74,20 @@ void SDLWindow::checkEvents()
         EventHandler::InvokeEventSubs(mp_event);
     }
 }
+
+void SDLWindow::waitEvents(int32_t timeoutMs)
+{
+    if (SDL_WaitEventTimeout(mp_event, timeoutMs))
+        EventHandler::InvokeEventSubs(mp_event);
+    checkEvents();
+}
+
+bool SDLWindow::isMinimized()
+{
+    return (SDL_GetWindowFlags(mp_window) & SDL_WINDOW_MINIMIZED) != 0;
+}
+
+bool SDLWindow::isFocused()
+{
+    return (SDL_GetWindowFlags(mp_window) & SDL_WINDOW_INPUT_FOCUS) != 0;
+}